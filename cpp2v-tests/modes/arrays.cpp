@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+// arrays of at least 16 literals are printed as one string
+char bytes[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+    'n', 'o', 'p'};
+wchar_t wide[] = {L'a', L'b', L'c', L'd', L'e', L'f', L'g', L'h', L'i', L'j',
+    L'k', L'l', L'm', L'n', L'o', L'p'};
+int ints[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+long casts[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
@@ -0,0 +1,37 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require arrays_cpp.
+
+(** the value of an element of an expanded array *)
+Definition value (e : Expr) : option Z :=
+  match e with
+  | Eint z _ | Echar z _ => Some z
+  | Ecast _ (_, Eint z _) _ => Some z
+  | _ => None
+  end.
+
+Definition values (m : translation_unit) (n : obj_name) : option (list Z) :=
+  match m.(symbols) !! n with
+  | Some (Ovar _ (Some (Einitlist l _ _))) => mapM value l
+  | _ => None
+  end.
+
+Definition from (start : nat) : list Z := Z.of_nat <$> seq start 16.
+
+(** the strings expand to the elements of the source *)
+Example arrays_bytes : values arrays_cpp.module "bytes" = Some (from 97).
+Proof. vm_compute. reflexivity. Qed.
+
+Example arrays_wide : values arrays_cpp.module "wide" = Some (from 97).
+Proof. vm_compute. reflexivity. Qed.
+
+Example arrays_ints : values arrays_cpp.module "ints" = Some (from 0).
+Proof. vm_compute. reflexivity. Qed.
+
+Example arrays_casts : values arrays_cpp.module "casts" = Some (from 1).
+Proof. vm_compute. reflexivity. Qed.
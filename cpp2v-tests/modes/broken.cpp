@@ -0,0 +1,8 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+// does not parse
+int broken( { return 0; }
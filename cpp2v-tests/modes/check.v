@@ -0,0 +1,25 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+(** comparisons of the translation units that are printed with different
+    options *)
+Require Import bedrock.lang.cpp.parser.
+
+(** [a] and [b] have the same entries *)
+Definition same_tables (a b : translation_unit) : bool :=
+  bool_decide (IM.elements a.(symbols) = IM.elements b.(symbols)) &&
+  bool_decide (IM.elements a.(globals) = IM.elements b.(globals)).
+
+(** [a] has an entry named [n] *)
+Definition has_symbol (a : translation_unit) (n : obj_name) : bool :=
+  bool_decide (is_Some (a.(symbols) !! n)).
+
+Definition has_global (a : translation_unit) (n : globname) : bool :=
+  bool_decide (is_Some (a.(globals) !! n)).
+
+(** the names of the entries of [a] are names of entries of [b] *)
+Definition sub_tables (a b : translation_unit) : bool :=
+  forallb (fun kv => has_symbol b kv.1) (IM.elements a.(symbols)) &&
+  forallb (fun kv => has_global b kv.1) (IM.elements a.(globals)).
@@ -0,0 +1,18 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_chunk_cpp.
+
+(** the chunks merge to the same translation unit *)
+Example chunk_same :
+  same_tables modes_chunk_cpp.module modes_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** and each chunk only has some of it *)
+Example chunk_part :
+  same_tables modes_chunk_cpp.modes_chunk_cpp_chunk1 modes_cpp.module = false.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,8 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+// parses, but computed gotos can not be printed
+void jump(void *target) { goto *target; }
@@ -0,0 +1,41 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_fold_cpp.
+
+Definition constant (m : translation_unit) (n : globname) : option Expr :=
+  match m.(globals) !! n with
+  | Some (Gconstant _ (Some e)) => Some e
+  | _ => None
+  end.
+
+(** -fold-constants prints the value of [Limits::size] rather than the
+    expression that computes it *)
+Example fold_value :
+  match constant modes_fold_cpp.module "_ZN5modes6Limits4sizeE" with
+  | Some (Eint 17 _) => true
+  | _ => false
+  end = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example fold_default :
+  match constant modes_cpp.module "_ZN5modes6Limits4sizeE" with
+  | Some (Ebinop _ _ _ _) => true
+  | _ => false
+  end = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** the functions, which only refer to the constants, are the same *)
+Example fold_symbols :
+  bool_decide (IM.elements modes_fold_cpp.module.(symbols) =
+               IM.elements modes_cpp.module.(symbols)) = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example fold_globals :
+  bool_decide (map fst (IM.elements modes_fold_cpp.module.(globals)) =
+               map fst (IM.elements modes_cpp.module.(globals))) = true.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,22 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_ids_cpp.
+
+Example ids_same :
+  same_tables modes_ids_cpp.module modes_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** looking the id of a name up finds what looking the name up finds *)
+Example ids_lookup :
+  forallb (fun ni =>
+    bool_decide (modes_ids_cpp.symbols_by_id !! ni.2 =
+                 modes_ids_cpp.module.(symbols) !! ni.1) &&
+    bool_decide (modes_ids_cpp.globals_by_id !! ni.2 =
+                 modes_ids_cpp.module.(globals) !! ni.1))
+    modes_ids_cpp.name_ids = true.
+Proof. vm_compute. reflexivity. Qed.
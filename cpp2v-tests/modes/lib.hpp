@@ -0,0 +1,18 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+// the definitions depend on the macros of the translation unit
+#ifndef LIB_VALUE
+#define LIB_VALUE 1
+#endif
+
+namespace lib {
+struct Box {
+    int v;
+};
+
+inline int value() { return LIB_VALUE; }
+} // namespace lib
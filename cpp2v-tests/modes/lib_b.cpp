@@ -0,0 +1,10 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#define LIB_VALUE 2
+#include "lib.hpp"
+
+int use_b(lib::Box b) { return b.v - lib::value(); }
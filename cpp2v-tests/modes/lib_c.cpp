@@ -0,0 +1,9 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "lib.hpp"
+
+int use_c() { return lib::value(); }
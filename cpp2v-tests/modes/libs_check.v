@@ -0,0 +1,22 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require lib_a_cpp lib_a_lib_cpp lib_b_cpp lib_b_lib_cpp lib_c_cpp
+        lib_c_lib_cpp.
+
+(** the modules that merge the header libraries are the translation units *)
+Example lib_a_same :
+  same_tables lib_a_lib_cpp.module lib_a_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example lib_b_same :
+  same_tables lib_b_lib_cpp.module lib_b_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example lib_c_same :
+  same_tables lib_c_lib_cpp.module lib_c_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "modes.hpp"
+
+namespace modes {
+struct Limits {
+    static constexpr int size = 4 * 4 + 1;
+};
+
+enum Color { red = 1 << 2, green, blue };
+
+template <typename T> T twice(T x) { return x + x; }
+
+int classify(int x) {
+    int y = 0;
+    switch (x) {
+    case 0:
+        y = 1;
+        break;
+    case 1:
+        y = 3;
+        break;
+    case 2:
+        y = 5;
+        break;
+    case 3:
+        y = 7;
+        break;
+    case 4:
+        y = 11;
+        break;
+    case 5:
+        y = 13;
+        break;
+    case 6:
+        y = 17;
+        break;
+    case 7:
+        y = 19;
+        break;
+    default:
+        y = used_helper(x);
+        break;
+    }
+    return y;
+}
+
+int sum(const Pair &p) {
+    int total = 0;
+    for (int i = 0; i < p.second; ++i) {
+        if (i % 2 == 0) {
+            total += twice(i);
+        } else {
+            total += twice<long>(i);
+        }
+    }
+    return total + p.first;
+}
+
+int entry(int x) {
+    Pair p{x, Limits::size};
+    return sum(p) + classify(x) + (x == red ? 1 : 0);
+}
+} // namespace modes
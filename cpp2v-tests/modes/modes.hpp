@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+namespace modes {
+inline int used_helper(int x) { return x + 1; }
+
+struct Pair {
+    int first;
+    int second;
+};
+} // namespace modes
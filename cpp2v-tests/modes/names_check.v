@@ -0,0 +1,13 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_names_cpp.
+
+(** the shared names unfold to the same translation unit *)
+Example names_same :
+  same_tables modes_names_cpp.module modes_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,9 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "modes.hpp"
+
+int other(int x) { return modes::used_helper(x) * 2; }
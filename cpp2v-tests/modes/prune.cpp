@@ -0,0 +1,9 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "prune.hpp"
+
+int main_fn(prune::Used u) { return prune::used(u.a); }
@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+namespace prune {
+struct Used {
+    int a;
+};
+
+struct Unused {
+    int b;
+};
+
+inline int used(int x) { return x + 1; }
+
+inline int unused(int x) { return x - 1; }
+} // namespace prune
@@ -0,0 +1,34 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require prune_cpp prune_pruned_cpp prune_root_cpp.
+
+(** -prune keeps what the main file uses and drops the rest of the header *)
+Example prune_sub :
+  sub_tables prune_pruned_cpp.module prune_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example prune_kept :
+  has_symbol prune_pruned_cpp.module "_Z7main_fnN5prune4UsedE" &&
+  has_symbol prune_pruned_cpp.module "_ZN5prune4usedEi" &&
+  has_global prune_pruned_cpp.module "_ZN5prune4UsedE" = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example prune_dropped :
+  has_symbol prune_pruned_cpp.module "_ZN5prune6unusedEi" ||
+  has_global prune_pruned_cpp.module "_ZN5prune6UnusedE" = false.
+Proof. vm_compute. reflexivity. Qed.
+
+(** -root starts from the named declaration instead of the main file *)
+Example root_kept :
+  has_symbol prune_root_cpp.module "_ZN5prune6unusedEi" = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example root_dropped :
+  has_symbol prune_root_cpp.module "_Z7main_fnN5prune4UsedE" ||
+  has_symbol prune_root_cpp.module "_ZN5prune4usedEi" = false.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+// the later declarations define less than the earlier ones, so they must not
+// replace them
+int x = 5;
+extern int x;
+
+int f();
+int f() { return x; }
+int f();
+
+extern int y;
+int y = 7;
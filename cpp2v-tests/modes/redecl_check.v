@@ -0,0 +1,21 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require redecl_cpp.
+
+(** the redeclaration with the initializer is kept, whether the [extern]
+    declaration comes before or after it *)
+Definition initialized (m : translation_unit) (n : obj_name) : bool :=
+  match m.(symbols) !! n with
+  | Some (Ovar _ (Some _)) => true
+  | _ => false
+  end.
+
+Example redecl_init :
+  initialized redecl_cpp.module "x" && initialized redecl_cpp.module "y"
+  = true.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,10 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "rules.hpp"
+#include "rules_extra.hpp"
+
+int rules_main(int x) { return x; }
@@ -0,0 +1,13 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+namespace rules {
+inline int shown(int x) { return x + 1; }
+
+namespace detail {
+inline int hidden(int x) { return x - 1; }
+} // namespace detail
+} // namespace rules
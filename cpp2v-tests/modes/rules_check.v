@@ -0,0 +1,39 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require rules_cpp rules_ns_cpp rules_last_cpp rules_path_cpp rules_file_cpp.
+
+Example rules_default :
+  has_symbol rules_cpp.module "_ZN5rules5shownEi" &&
+  has_symbol rules_cpp.module "_ZN5rules6detail6hiddenEi" &&
+  has_symbol rules_cpp.module "_Z5extrai" = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** -exclude-ns drops the namespace and the namespaces nested in it *)
+Example rules_ns :
+  sub_tables rules_ns_cpp.module rules_cpp.module &&
+  has_symbol rules_ns_cpp.module "_ZN5rules5shownEi" &&
+  negb (has_symbol rules_ns_cpp.module "_ZN5rules6detail6hiddenEi") = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** the last matching rule wins *)
+Example rules_last :
+  negb (has_symbol rules_last_cpp.module "_ZN5rules5shownEi") &&
+  has_symbol rules_last_cpp.module "_ZN5rules6detail6hiddenEi" = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** -exclude-path drops the declarations of the matching files *)
+Example rules_path :
+  has_symbol rules_path_cpp.module "_Z10rules_maini" &&
+  has_symbol rules_path_cpp.module "_ZN5rules5shownEi" &&
+  negb (has_symbol rules_path_cpp.module "_Z5extrai") = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** -filter-file reads the same rules *)
+Example rules_file :
+  same_tables rules_file_cpp.module rules_ns_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,7 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+inline int extra(int x) { return x * 2; }
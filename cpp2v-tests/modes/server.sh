@@ -0,0 +1,55 @@
+#!/bin/sh
+#
+# Copyright (C) BedRock Systems Inc. 2020
+#
+# SPDX-License-Identifier:AGPL-3.0-or-later
+#
+# check the protocol of `cpp2v -server`, $1 is cpp2v
+set -e
+CPP2V=$1
+SOCK=server.sock
+
+# send the request on stdin and print the response
+send() {
+    python3 -c '
+import socket, sys
+s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+s.connect(sys.argv[1])
+s.sendall(sys.stdin.buffer.read())
+sys.stdout.write(s.makefile().read())
+' "$SOCK"
+}
+
+# send the request on stdin and check the response
+expect() {
+    response=`send`
+    if [ "$response" != "$1" ]; then
+        echo "expected '$1', got '$response'" >&2
+        exit 1
+    fi
+}
+
+rm -f $SOCK server_cpp.v
+$CPP2V -server $SOCK -server-timeout 1 -- &
+server=$!
+trap 'kill $server 2> /dev/null || true' EXIT
+for i in 1 2 3 4 5 6 7 8 9 10; do
+    test -S $SOCK && break
+    sleep 1
+done
+
+printf 'source modes.cpp\no server_cpp.v\nend\n' | expect ok
+cmp server_cpp.v modes_cpp.v
+# the second request reparses the unit that the first one kept
+rm server_cpp.v
+printf 'source modes.cpp\no server_cpp.v\nend\n' | expect ok
+cmp server_cpp.v modes_cpp.v
+
+printf 'source broken.cpp\nend\n' | expect "error failed to parse broken.cpp"
+printf 'bogus\nend\n' | expect "error malformed request"
+# the request is never finished, the server gives up on it
+printf 'source modes.cpp\n' | expect "error request timed out"
+
+printf 'shutdown\n' | expect ok
+wait $server
+test ! -e $SOCK
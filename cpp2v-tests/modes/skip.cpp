@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+template <typename T> struct Box {
+    T value;
+};
+
+// Box<long> is only instantiated by the body
+int unbox() {
+    Box<long> b{1};
+    return static_cast<int>(b.value);
+}
@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+struct Counter {
+    int value;
+
+    /// \spec counter_get_spec
+    int get() const;
+};
+
+/// \spec counter_get_spec
+int Counter::get() const { return value; }
@@ -0,0 +1,18 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_split_cpp modes_split_cpp_part1.
+
+(** the parts of a split module merge to the same translation unit *)
+Example split_same :
+  same_tables modes_split_cpp.module modes_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** and each part only has some of it *)
+Example split_part :
+  same_tables modes_split_cpp_part1.module modes_cpp.module = false.
+Proof. vm_compute. reflexivity. Qed.
@@ -0,0 +1,25 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require modes_cpp modes_stream_cpp redecl_cpp redecl_stream_cpp.
+
+(** streaming the module does not change it, whatever the window *)
+Example stream_same :
+  same_tables modes_stream_cpp.module modes_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+Example stream_redecl :
+  same_tables redecl_stream_cpp.module redecl_cpp.module = true.
+Proof. vm_compute. reflexivity. Qed.
+
+(** the definition of [x] is kept over its later [extern] declaration *)
+Example stream_init :
+  match redecl_stream_cpp.module.(symbols) !! "x"%bs with
+  | Some (Ovar _ (Some _)) => true
+  | _ => false
+  end = true.
+Proof. vm_compute. reflexivity. Qed.
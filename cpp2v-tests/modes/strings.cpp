@@ -0,0 +1,8 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+char plain[] = "hello";
+char escaped[] = "tab\there \"quoted\" back\\slash\n";
@@ -0,0 +1,36 @@
+(*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ *)
+Require Import bedrock.lang.cpp.parser.
+Require Import check.
+Require strings_cpp.
+
+(** [bs_unescape] decodes the escapes that cpp2v prints *)
+Example unescape_backslash : bs_unescape "a\\b" = "a\b".
+Proof. vm_compute. reflexivity. Qed.
+
+Example unescape_hex : bs_unescape "\x41\x7e\x5c" = "A~\".
+Proof. vm_compute. reflexivity. Qed.
+
+Example unescape_plain : bs_unescape "x\y" = "x\y".
+Proof. vm_compute. reflexivity. Qed.
+
+Definition literal (m : translation_unit) (n : obj_name) : option bs :=
+  match m.(symbols) !! n with
+  | Some (Ovar _ (Some (Estring s _))) => Some s
+  | _ => None
+  end.
+
+(** the string literals have the bytes of the source *)
+Example strings_plain :
+  literal strings_cpp.module "plain" = Some "hello"%bs.
+Proof. vm_compute. reflexivity. Qed.
+
+Example strings_escaped :
+  literal strings_cpp.module "escaped" =
+  Some ("tab" ++ Bytestring.String Byte.x09
+          ("here ""quoted"" back\slash" ++
+           Bytestring.String Byte.x0a Bytestring.EmptyString))%bs.
+Proof. vm_compute. reflexivity. Qed.
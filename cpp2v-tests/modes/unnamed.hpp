@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+namespace modes {
+struct Holder {
+    struct {
+        int a;
+    } inner;
+    union {
+        int i;
+        float f;
+    } value;
+};
+
+inline int read(const Holder &h) { return h.inner.a + h.value.i; }
+} // namespace modes
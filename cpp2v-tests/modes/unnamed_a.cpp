@@ -0,0 +1,9 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+#include "unnamed.hpp"
+
+int first(const modes::Holder &h) { return modes::read(h); }
@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020
+ *
+ * SPDX-License-Identifier:MIT-0
+ */
+
+// numbered before the unnamed types of the header
+struct {
+    int z;
+} before;
+
+#include "unnamed.hpp"
+
+int second(const modes::Holder &h) { return modes::read(h) + before.z; }
@@ -5,6 +5,21 @@
  */
 #pragma once
 #include <clang/Basic/Diagnostic.h>
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/Optional.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Allocator.h>
+
+namespace llvm {
+class APSInt;
+class raw_string_ostream;
+}
+
+namespace fmt {
+class Formatter;
+}
 
 namespace clang {
 class Decl;
@@ -24,6 +39,8 @@ class SourceRange;
 }
 
 class CoqPrinter;
+class SharedDefs;
+class SortedModule;
 
 class ClangPrinter {
 public:
@@ -35,6 +52,12 @@ public:
 
     void printStmt(const clang::Stmt* s, CoqPrinter& print);
 
+    // print the statements of a block as a list. when blocks are outlined,
+    // the rest of the list is defined separately every time the statements
+    // before it reach the size of a block.
+    void printStmtList(llvm::ArrayRef<const clang::Stmt*> stmts,
+                       CoqPrinter& print);
+
     void printType(const clang::Type* t, CoqPrinter& print);
 
     void printExpr(const clang::Expr* d, CoqPrinter& print);
@@ -44,6 +67,19 @@ public:
     void printGlobalName(const clang::NamedDecl* decl, CoqPrinter& print,
                          bool raw = false);
 
+    // the mangled name of `decl`, which is computed once per declaration
+    llvm::StringRef mangledName(const clang::NamedDecl* decl);
+
+    // number the unnamed types of the translation unit in the order that
+    // they are declared. the mangler numbers them in the order that it first
+    // sees them, so otherwise their names depend on which declarations are
+    // printed before.
+    void numberUnnamedTypes();
+
+    // identifies the unnamed types that are declared up to the end of `decl`
+    // (and so their numbers), or `None` if they are not known
+    llvm::Optional<size_t> unnamedTypesBefore(const clang::Decl* decl) const;
+
     void printName(const clang::NamedDecl* decl, CoqPrinter& print);
 
     void printQualType(const clang::QualType& qt, CoqPrinter& print);
@@ -63,8 +99,67 @@ public:
 
     ClangPrinter(clang::ASTContext* context);
 
+    // print terms through the definitions in `defs`, or inline if it is null
+    void setShared(SharedDefs* defs) {
+        shared_ = defs;
+    }
+
+    SharedDefs* getShared() const {
+        return shared_;
+    }
+
+    // add declarations to `module` as its entries rather than printing
+    // them, if it is not null
+    void setSorted(SortedModule* module) {
+        sorted_ = module;
+    }
+
+    SortedModule* getSorted() const {
+        return sorted_;
+    }
+
+    // print the values of constant initializers (and of `sizeof` and
+    // `alignof`) rather than the expressions that compute them
+    void setFold(bool fold) {
+        fold_ = fold;
+    }
+
+    bool getFold() const {
+        return fold_;
+    }
+
+    // print `value` as a literal of type `type`, i.e. `Ebool` or `Eint`
+    void printValue(const llvm::APSInt& value, const clang::QualType& type,
+                    CoqPrinter& print);
+
+    // print the value of `expr` if constants are folded and it evaluates to
+    // an integer, returns false (and prints nothing) otherwise
+    bool printFolded(const clang::Expr* expr, CoqPrinter& print);
+
+private:
+    // print the term printed by `body` as a shared definition named
+    // `prefix`<n> of type `type` if it is at least `min_size` characters
+    // long, otherwise inline. `key` identifies the AST node so that it is
+    // only printed once, it may be null.
+    void printShared(const void* key, llvm::StringRef prefix,
+                     llvm::StringRef type, size_t min_size, CoqPrinter& print,
+                     llvm::function_ref<void(CoqPrinter&)> body);
+
 private:
     clang::ASTContext* context_;
     clang::MangleContext* mangleContext_;
     clang::DiagnosticsEngine engine_;
+    // mangled names keyed by the canonical declaration, the strings live in
+    // `names_arena_`
+    llvm::DenseMap<const clang::NamedDecl*, llvm::StringRef> names_;
+    llvm::BumpPtrAllocator names_arena_;
+    // see `unnamedTypesBefore`
+    llvm::DenseMap<const clang::Decl*, size_t> unnamed_;
+    SharedDefs* shared_;
+    // the buffer of the outermost shared term that is being printed, the
+    // terms in it are printed in place and only cut out if they are shared
+    fmt::Formatter* term_fmt_;
+    llvm::raw_string_ostream* term_out_;
+    SortedModule* sorted_;
+    bool fold_;
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "clang/Basic/SourceLocation.h"
+#include "clang/Basic/Version.inc"
+#include "llvm/ADT/DenseMap.h"
+#include <vector>
+
+namespace clang {
+class ASTContext;
+class Decl;
+class RawComment;
+}
+
+/* The comments of a translation unit, indexed by file and sorted by their
+ * offset in the file.
+ *
+ * Comments are attached to declarations with the rules of
+ * `ASTContext::getRawCommentForDeclNoCache`, but each lookup is a binary
+ * search in the comments of one file rather than a search through all of
+ * the comments of the translation unit. Since clang 10 keeps the comments of
+ * each file apart itself, the lookup is left to clang there.
+ */
+class CommentIndex {
+public:
+    explicit CommentIndex(const clang::ASTContext &ctxt);
+
+    // the comment that documents `decl`, or null if there is none
+    clang::RawComment *comment_for(const clang::Decl *decl);
+
+private:
+#if CLANG_VERSION_MAJOR < 10
+    struct Entry {
+        unsigned begin;
+        unsigned end;
+        clang::RawComment *comment;
+    };
+#endif
+
+private:
+    const clang::ASTContext &ctxt_;
+#if CLANG_VERSION_MAJOR < 10
+    llvm::DenseMap<clang::FileID, std::vector<Entry>> files_;
+#endif
+};
@@ -5,6 +5,7 @@
  */
 #include "Formatter.hpp"
 #include "llvm/ADT/StringRef.h"
+#include <string>
 
 class CoqPrinter {
 public:
@@ -65,6 +66,41 @@ public:
         return this->output_ << "\"" << str << "\"";
     }
 
+    // `data` as one bytestring literal. bytes that can not be written in a
+    // Coq string are written `\xNN` (and `\` as `\\`), which `bs_unescape`
+    // decodes
+    fmt::Formatter& bytes(llvm::StringRef data) {
+        bool escape = false;
+        for (unsigned char c : data) {
+            if (c < 0x20 || 0x7e < c) {
+                escape = true;
+                break;
+            }
+        }
+        std::string text;
+        text.reserve(data.size() + 2);
+        text += '"';
+        for (unsigned char c : data) {
+            if (c == '"') {
+                text += "\"\"";
+            } else if (escape && c == '\\') {
+                text += "\\\\";
+            } else if (c < 0x20 || 0x7e < c) {
+                const char* digits = "0123456789abcdef";
+                text += "\\x";
+                text += digits[c >> 4];
+                text += digits[c & 0xf];
+            } else {
+                text += c;
+            }
+        }
+        text += "\"%bs";
+        if (escape) {
+            return this->output_ << "(bs_unescape" << fmt::nbsp << text << ")";
+        }
+        return this->output_ << text;
+    }
+
     fmt::Formatter& boolean(bool b) {
         return this->output_ << (b ? "true" : "false");
     }
@@ -4,9 +4,11 @@
  * SPDX-License-Identifier:AGPL-3.0-or-later
  */
 #pragma once
+#include "CommentIndex.hpp"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/DenseMap.h"
 #include <list>
 
 using namespace clang;
@@ -52,6 +54,9 @@ public:
 class NoInclude : public Filter {
 private:
     const SourceManager &SM;
+    // the answer for each file, every location of a file has the same
+    // include location unless there are line markers
+    llvm::DenseMap<FileID, bool> files;
 
 public:
     NoInclude(SourceManager &_SM) : SM(_SM) {}
@@ -62,16 +67,20 @@ public:
         if (!loc.isValid()) {
             return false;
         }
-        PresumedLoc PLoc = SM.getPresumedLoc(loc);
-        if (PLoc.isInvalid()) {
-            return false;
-        } else {
-            if (PLoc.getIncludeLoc().isValid()) {
-                return true;
-            } else {
-                return false;
+        bool memo = !SM.hasLineTable();
+        FileID file = SM.getFileID(SM.getExpansionLoc(loc));
+        if (memo) {
+            auto found = files.find(file);
+            if (found != files.end()) {
+                return found->second;
             }
         }
+        PresumedLoc PLoc = SM.getPresumedLoc(loc);
+        bool result = !PLoc.isInvalid() && PLoc.getIncludeLoc().isValid();
+        if (memo) {
+            files[file] = result;
+        }
+        return result;
     }
 
     virtual What shouldInclude(const Decl *d) {
@@ -109,12 +118,13 @@ public:
 class FromComment : public Filter {
 private:
     const ASTContext *const ctxt;
+    CommentIndex comments;
 
 public:
-    FromComment(const ASTContext *_ctxt) : ctxt(_ctxt) {}
+    FromComment(const ASTContext *_ctxt) : ctxt(_ctxt), comments(*_ctxt) {}
 
     virtual What shouldInclude(const Decl *d) {
-        if (auto comment = ctxt->getRawCommentForDeclNoCache(d)) {
+        if (auto comment = comments.comment_for(d)) {
             auto text = comment->getRawText(ctxt->getSourceManager());
             if (StringRef::npos != text.find("definition")) {
                 return What::DEFINITION;
@@ -22,6 +22,10 @@ public:
     explicit Formatter();
     explicit Formatter(llvm::raw_ostream&);
 
+    // continue a line of another formatter at indentation `depth`, the
+    // result can be copied back using `splice`
+    Formatter(llvm::raw_ostream&, unsigned int depth);
+
     llvm::raw_ostream& line();
 
     llvm::raw_ostream& nobreak();
@@ -33,6 +37,17 @@ public:
 
     void ascii(int c);
 
+    // copy text printed by a formatter that continued the current line
+    void splice(llvm::StringRef text);
+
+    // like `splice`, but `text` was printed at depth 0, so its lines are
+    // indented to the current depth
+    void splice_indented(llvm::StringRef text);
+
+    // the text printed since the line was continued was cut from the output,
+    // continue the line from there
+    void continue_line();
+
     llvm::raw_ostream& error() const;
 
     template<typename T>
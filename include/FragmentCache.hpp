@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <mutex>
+#include <string>
+
+namespace clang {
+class ASTContext;
+class Decl;
+}
+
+/* The printed declarations of headers, shared between the translation units
+ * translated by one process (with -j, -out-dir or the server).
+ *
+ * A declaration is identified by its fingerprint, which combines the target
+ * and language options, the qualified name, the ODR hash of the declaration
+ * (which covers the types it references and, for functions, the body after
+ * macro expansion), a hash of its source text and the unnamed types that
+ * are declared before it, which are numbered in order by the mangler (see
+ * `ClangPrinter::numberUnnamedTypes`). The cache is safe to use from multiple
+ * threads.
+ */
+class FragmentCache {
+public:
+    // the options of the translation unit that change how declarations
+    // are printed
+    static std::string context_key(const clang::ASTContext& ctxt);
+
+    // the fingerprint of `decl` printed at indentation `depth`, after the
+    // unnamed types identified by `unnamed`, or the empty string if `decl`
+    // can not be shared
+    static std::string fingerprint(const clang::Decl* decl,
+                                   llvm::StringRef context_key,
+                                   unsigned depth, size_t unnamed);
+
+    bool lookup(llvm::StringRef key, std::string& text) const;
+
+    void insert(llvm::StringRef key, llvm::StringRef text);
+
+private:
+    mutable std::mutex mutex_;
+    llvm::StringMap<std::string> fragments_;
+};
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "llvm/ADT/StringRef.h"
+#include <mutex>
+#include <set>
+#include <string>
+
+/* The libraries that hold the declarations of headers.
+ *
+ * Each header gets its own library (a module defining `module`), which is
+ * written by the first translation unit of the process that includes it. The
+ * modules of translation units only contain their own declarations and merge
+ * in the libraries of their headers. The libraries of translation units that
+ * are printed with different options (the `variant`), or in which the header
+ * defines different declarations (e.g. because of the macros defined before
+ * it is included), are kept apart.
+ */
+class HeaderLibraries {
+public:
+    explicit HeaderLibraries(llvm::StringRef dir) : dir_(dir.str()) {}
+
+    // the prefix of the names of the libraries of `header` printed with the
+    // options `variant`
+    std::string prefix(llvm::StringRef header, llvm::StringRef variant) const;
+
+    // the Coq module name of the library with the name `prefix` that consists
+    // of the text `contents`
+    std::string module_name(llvm::StringRef prefix,
+                            llvm::StringRef contents) const;
+
+    // the file of the library `module`
+    std::string path(llvm::StringRef module) const;
+
+    // returns true the first time it is called with `module`, the caller is
+    // then responsible for writing the library
+    bool claim(llvm::StringRef module);
+
+private:
+    const std::string dir_;
+    std::mutex mutex_;
+    std::set<std::string> claimed_;
+};
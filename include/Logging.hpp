@@ -35,5 +35,7 @@ debug() {
 
 void set_level(Level level);
 
+// stop after a fatal error. inside a `llvm::CrashRecoveryContext` (the
+// workers of -j) only the translation unit fails, otherwise the process exits
 [[noreturn]] void die();
 }
\ No newline at end of file
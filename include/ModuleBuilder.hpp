@@ -5,36 +5,68 @@
  */
 #pragma once
 #include <clang/AST/Decl.h>
-#include <list>
-#include <map>
-#include <utility>
+#include <llvm/ADT/DenseMap.h>
+#include <vector>
 
-class Module {
+// receives the declarations of a translation unit in the order that they
+// are found
+class DeclSink {
 public:
-    void add_definition(const clang::NamedDecl* d, bool opaque = false);
+    virtual ~DeclSink() {}
 
-    void add_declaration(const clang::NamedDecl* d);
+    virtual void add_definition(const clang::NamedDecl* d,
+                                bool opaque = false) = 0;
 
-    const std::multimap<std::string, std::pair<const clang::NamedDecl*, bool>>&
-    imports() const {
+    virtual void add_declaration(const clang::NamedDecl* d) = 0;
+};
+
+/* The declarations of a translation unit.
+ *
+ * Each declaration (identified by its canonical declaration) is kept once,
+ * at the position that it was first added, which is the order of the
+ * declarations in the source. A later redeclaration replaces the one that
+ * is kept if it defines more, e.g. the definition of a variable replaces an
+ * `extern` declaration of it. This makes the output independent of the
+ * names of the declarations and of the addresses they are allocated at.
+ */
+class Module : public DeclSink {
+public:
+    void add_definition(const clang::NamedDecl* d,
+                        bool opaque = false) override;
+
+    void add_declaration(const clang::NamedDecl* d) override;
+
+    const std::vector<const clang::NamedDecl*>& imports() const {
         return imports_;
     }
 
-    const std::multimap<std::string, const clang::NamedDecl*>&
-    definitions() const {
+    const std::vector<const clang::NamedDecl*>& definitions() const {
         return definitions_;
     }
 
     Module() : imports_(), definitions_() {}
 
 private:
-    std::multimap<std::string, std::pair<const clang::NamedDecl*, bool>>
-        imports_;
-    std::multimap<std::string, const clang::NamedDecl*> definitions_;
+    std::vector<const clang::NamedDecl*> imports_;
+    std::vector<const clang::NamedDecl*> definitions_;
+    // the position of each canonical declaration in `imports_` and
+    // `definitions_`
+    llvm::DenseMap<const clang::Decl*, size_t> imported_;
+    llvm::DenseMap<const clang::Decl*, size_t> defined_;
 };
 
+// how much of its entity `d` defines, e.g. the redeclaration of a variable
+// with its initializer defines more than an `extern` declaration of it
+int defines(const clang::NamedDecl* d);
+
 class Filter;
 class SpecCollector;
 
-void build_module(const clang::TranslationUnitDecl* tu, ::Module& mod,
-                  Filter& filter, SpecCollector& specs);
+// the specifications of the declarations are added to `specs` unless it is
+// null
+void build_module(const clang::TranslationUnitDecl* tu, DeclSink& mod,
+                  Filter& filter, SpecCollector* specs);
+
+// is `decl` (or the declaration that it is part of) an instantiation of a
+// template
+bool is_instantiated(const clang::Decl* decl);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "Filter.hpp"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/GlobPattern.h"
+#include <string>
+#include <vector>
+
+/* Rules that include or exclude declarations by the path of the file that
+ * they are declared in or by their enclosing namespace.
+ *
+ * Paths are matched with globs, where `*` also matches `/`, e.g.
+ * `/usr/include/*`. Namespaces are matched by prefix, so `std::__detail`
+ * matches `std::__detail` and its nested namespaces. When several rules of
+ * the same kind match, the last one wins, and a declaration is excluded if
+ * either its path or its namespace is excluded.
+ */
+class PathRules {
+public:
+    enum class Kind { Path, Namespace };
+
+    // add a rule, returns false if `pattern` is not a valid glob
+    bool add(bool include, Kind kind, llvm::StringRef pattern);
+
+    // read the rules in `file`, one per line, written `+path <glob>`,
+    // `-path <glob>`, `+ns <prefix>` or `-ns <prefix>`. empty lines and lines
+    // starting with `#` are ignored. returns false (and reports why) if the
+    // file can not be read or has a malformed line.
+    bool read(llvm::StringRef file);
+
+    // describes the rules, to identify the output in caches
+    const std::string &text() const {
+        return text_;
+    }
+
+    // the verdict of the last rule of `kind` that matches `str`, `None` if no
+    // rule matches
+    llvm::Optional<bool> match(Kind kind, llvm::StringRef str) const;
+
+private:
+    struct Rule {
+        bool include;
+        Kind kind;
+        std::string prefix;
+        llvm::Optional<llvm::GlobPattern> glob;
+    };
+
+    std::vector<Rule> rules_;
+    std::string text_;
+};
+
+/* Applies `PathRules` to the declarations of a translation unit.
+ *
+ * The path of each file and each namespace is only classified once, so the
+ * check for a declaration is a lookup of its file and namespace.
+ */
+class PathPolicy : public Filter {
+public:
+    PathPolicy(const PathRules &rules, const SourceManager &sm)
+        : rules_(rules), sm_(sm) {}
+
+    virtual What shouldInclude(const Decl *d);
+
+private:
+    bool excluded(FileID file);
+    bool excluded(const DeclContext *dc);
+
+private:
+    const PathRules &rules_;
+    const SourceManager &sm_;
+    llvm::DenseMap<FileID, bool> files_;
+    llvm::DenseMap<const DeclContext *, bool> namespaces_;
+};
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "ModuleBuilder.hpp"
+#include "llvm/ADT/ArrayRef.h"
+#include <string>
+#include <vector>
+
+/* Holds back the declarations of a translation unit until all of them are
+ * found, and then only passes on the ones that are reachable from the roots.
+ *
+ * The roots are the declarations of the main file, or the declarations with
+ * the qualified names in `roots` if it is not empty. A declaration reaches
+ * the declarations that it refers to through types, calls, constructions,
+ * fields, bases and destructors.
+ */
+class PruningSink : public DeclSink {
+public:
+    explicit PruningSink(llvm::ArrayRef<std::string> roots)
+        : roots_(roots.begin(), roots.end()) {}
+
+    void add_definition(const clang::NamedDecl* d, bool opaque) override {
+        found_.push_back(Found{d, true, opaque});
+    }
+
+    void add_declaration(const clang::NamedDecl* d) override {
+        found_.push_back(Found{d, false, false});
+    }
+
+    // pass the reachable declarations to `sink` in the order they were found
+    void flush(DeclSink& sink);
+
+private:
+    struct Found {
+        const clang::NamedDecl* decl;
+        bool definition;
+        bool opaque;
+    };
+
+    const std::vector<std::string> roots_;
+    std::vector<Found> found_;
+};
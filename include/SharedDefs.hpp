@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+#include <vector>
+
+namespace fmt {
+class Formatter;
+}
+
+// the terms that are printed once, as definitions before the module, rather
+// than at every use
+struct Sharing {
+    // mangled names
+    bool names = false;
+    // qualified types
+    bool types = false;
+    // statements and expressions that print to at least this many
+    // characters, 0 disables them
+    unsigned terms = 0;
+    // blocks that print to at least this many characters, so that no term
+    // of a function body gets larger than that, 0 disables them
+    unsigned blocks = 0;
+
+    bool enabled() const {
+        return names || types || terms != 0 || blocks != 0;
+    }
+};
+
+/* The definitions shared by the terms of one generated file.
+ *
+ * The definitions are local to the file and are unfolded when the module is
+ * reduced, so sharing does not change the resulting translation unit.
+ */
+class SharedDefs {
+public:
+    explicit SharedDefs(const Sharing& sharing) : sharing_(sharing) {}
+
+    const Sharing& sharing() const {
+        return sharing_;
+    }
+
+    // the name of the definition of `term` of type `type`, which is added if
+    // it does not exist yet. new names start with `prefix`.
+    std::string define(llvm::StringRef prefix, llvm::StringRef type,
+                       llvm::StringRef term);
+
+    // the definition already used for the AST node `key`, or null
+    const std::string* find(const void* key) const {
+        auto found = nodes_.find(key);
+        return found == nodes_.end() ? nullptr : &found->second;
+    }
+
+    void remember(const void* key, llvm::StringRef name) {
+        nodes_[key] = name.str();
+    }
+
+    bool empty() const {
+        return defs_.empty();
+    }
+
+    // print the definitions in the order they were added, so each one only
+    // refers to the ones before it
+    void write(fmt::Formatter& fmt) const;
+
+private:
+    struct Def {
+        std::string name;
+        std::string type;
+        std::string term;
+    };
+
+    const Sharing sharing_;
+    llvm::StringMap<unsigned> index_;
+    std::vector<Def> defs_;
+    // avoids re-printing nodes that are used many times, e.g. types
+    llvm::DenseMap<const void*, std::string> nodes_;
+};
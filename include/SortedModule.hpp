@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+#include <vector>
+
+class CoqPrinter;
+
+/* The entries of the symbol and type tables of a translation unit.
+ *
+ * `parser.v` builds the tables by inserting the `D*` declarations one at a
+ * time under `vm_compute`. Here the entries are sorted by key, in the order
+ * of `bs_cmp`, and printed as balanced trees that `avl.of_sorted` turns
+ * into the tables without any reduction when the module is compiled.
+ */
+class SortedModule {
+public:
+    enum Table { Symbols, Globals };
+
+    // add the entry `key` := `value` to `table`, replacing an earlier entry
+    // for `key`. `name` is `key` as it is printed.
+    void add(Table table, llvm::StringRef key, std::string name,
+             std::string value);
+
+    // print the translation unit
+    void write(CoqPrinter& print) const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string name;
+        std::string value;
+    };
+
+    // print `entries` as a balanced tree, returns its height
+    static unsigned write_tree(llvm::ArrayRef<const Entry*> entries,
+                               CoqPrinter& print);
+
+    std::vector<Entry> tables_[2];
+};
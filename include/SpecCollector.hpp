@@ -4,6 +4,7 @@
  * SPDX-License-Identifier:AGPL-3.0-or-later
  */
 #pragma once
+#include <list>
 #include <map>
 #include <utility>
 
@@ -21,8 +22,13 @@ public:
     void add_specification(const clang::NamedDecl* decl, RawComment* ref,
                            ASTContext& context) {
         ref->setAttached();
-        this->comment_decl_.insert(std::make_pair(ref, decl));
-        if (auto comment = context.getCommentForDecl(decl, nullptr)) {
+        // note: the comment is looked up rather than parsed from `ref`, so
+        // that it is resolved like clang does, e.g. through the templates
+        // and redeclarations of `decl`
+        auto comment = context.getCommentForDecl(decl, nullptr);
+        this->comment_decl_.insert(
+            std::make_pair(ref, std::make_pair(decl, comment)));
+        if (comment) {
             this->specifications_.push_back(std::make_pair(decl, comment));
         }
     }
@@ -44,17 +50,36 @@ public:
         if (result == comment_decl_.end()) {
             return {};
         }
-        return result->second;
+        return result->second.first;
+    }
+
+    // the parsed comment `cmt` of `decl_for_comment(cmt)`
+    comments::FullComment* full_comment(RawComment* cmt) const {
+        auto result = comment_decl_.find(cmt);
+        if (result == comment_decl_.end()) {
+            return nullptr;
+        }
+        return result->second.second;
     }
 
 private:
     std::list<std::pair<const clang::NamedDecl*, comments::FullComment*>>
         specifications_;
-    std::map<RawComment*, const NamedDecl*> comment_decl_;
+    std::map<RawComment*,
+             std::pair<const NamedDecl*, comments::FullComment*>>
+        comment_decl_;
 };
 
-void write_spec(::Module* mod, const SpecCollector& specs,
+// `globals` is the text printed by `write_globals`
+void write_spec(const SpecCollector& specs,
                 const clang::TranslationUnitDecl* tu, Filter& filter,
+                llvm::StringRef globals, ClangPrinter& cprint,
                 fmt::Formatter& output);
 
-void write_globals(::Module& mod, CoqPrinter& print, ClangPrinter& cprint);
\ No newline at end of file
+void write_globals(::Module& mod, CoqPrinter& print, ClangPrinter& cprint);
+
+// `write_globals` one definition at a time
+void begin_globals(CoqPrinter& print);
+void write_global(const clang::NamedDecl* def, CoqPrinter& print,
+                  ClangPrinter& cprint);
+void end_globals(CoqPrinter& print);
\ No newline at end of file
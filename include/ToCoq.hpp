@@ -6,12 +6,65 @@
 #pragma once
 
 #include <optional>
+#include <string>
+#include <vector>
+
+#include "SharedDefs.hpp"
 
 namespace clang {
 class TranslationUnitDecl;
 }
 
 class CoqPrinter;
+class TranslationCache;
+class FragmentCache;
+class HeaderLibraries;
+class PathRules;
+
+// which declarations of a module are printed, and how
+struct ModuleFormat {
+    // the tables of the module, sorted, rather than its declarations
+    bool sorted = false;
+    // reduce the declarations in chunks of this many, 0 reduces them all
+    // at once
+    unsigned chunk = 0;
+    // also print the tables keyed by dense ids for the names
+    bool ids = false;
+    // only print the declarations that are reachable from the main file, or
+    // from the declarations named in `roots` if it is not empty
+    bool prune = false;
+    std::vector<std::string> roots;
+    // only print the declarations that `paths` does not exclude
+    const PathRules *paths = nullptr;
+    // print the values of constant initializers rather than the expressions
+    // that compute them
+    bool fold = false;
+};
+
+// the options of a translation, which can be shared by the translation units
+// of a process
+struct ToCoqOptions {
+    // the generated files are added to `cache` under `cache_key` (see
+    // `TranslationCache::key`), unless it is empty
+    const TranslationCache *cache = nullptr;
+    std::string cache_key;
+    // describes the options of the translation unit, they name the header
+    // libraries
+    std::string flags;
+    // the printed declarations of headers are shared through `fragments`
+    FragmentCache *fragments = nullptr;
+    // the number of files that the module is split into
+    unsigned split = 0;
+    // the definitions of headers are written to `libraries`
+    HeaderLibraries *libraries = nullptr;
+    // print declarations as they are found, holding back at most
+    // `stream_window` of them
+    bool stream = false;
+    unsigned stream_window = 0;
+    // the terms that are printed through shared definitions
+    Sharing sharing;
+    ModuleFormat format;
+};
 
 using namespace clang;
 
@@ -19,9 +72,10 @@ class ToCoqConsumer : public clang::ASTConsumer {
 public:
     explicit ToCoqConsumer(const Optional<std::string> output_file,
                            const Optional<std::string> spec_file,
-                           const Optional<std::string> notations_file)
+                           const Optional<std::string> notations_file,
+                           const ToCoqOptions &options = ToCoqOptions())
         : spec_file_(spec_file), output_file_(output_file),
-          notations_file_(notations_file) {}
+          notations_file_(notations_file), options_(options) {}
 
     virtual void HandleTranslationUnit(clang::ASTContext &Context) {
         toCoqModule(&Context, Context.getTranslationUnitDecl());
@@ -35,4 +89,5 @@ private:
     const Optional<std::string> spec_file_;
     const Optional<std::string> output_file_;
     const Optional<std::string> notations_file_;
+    const ToCoqOptions options_;
 };
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+
+namespace clang {
+class SourceManager;
+}
+
+/* An on-disk cache of generated files.
+ *
+ * Entries are addressed by the paths and contents of every file read by the
+ * translation unit, the options it was compiled with and the version of
+ * cpp2v, so the cache can be shared between builds (and users) that use the
+ * same paths as long as it lives on a file system that supports atomic
+ * renames.
+ */
+class TranslationCache {
+public:
+    explicit TranslationCache(llvm::StringRef dir) : dir_(dir.str()) {}
+
+    // the key of a translation unit that `sm` has (at least) preprocessed,
+    // `flags` must describe every option that changes the parse or the
+    // output. returns the empty string if the translation unit can not be
+    // cached.
+    std::string key(const clang::SourceManager& sm,
+                    llvm::StringRef flags) const;
+
+    // copy the cached outputs into the requested files, returns false if any
+    // requested output is not in the cache
+    bool fetch(llvm::StringRef key, const llvm::Optional<std::string>& module,
+               const llvm::Optional<std::string>& names,
+               const llvm::Optional<std::string>& spec) const;
+
+    // add the generated files to the cache, the outputs that were not
+    // written must be passed as `None`
+    void store(llvm::StringRef key, const llvm::Optional<std::string>& module,
+               const llvm::Optional<std::string>& names,
+               const llvm::Optional<std::string>& spec) const;
+
+private:
+    std::string entry(llvm::StringRef key, llvm::StringRef kind) const;
+
+private:
+    const std::string dir_;
+};
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#pragma once
+#include <string>
+
+struct ToCoqOptions;
+
+/* Serve translation requests on the Unix domain socket `socket_path`.
+ *
+ * Each connection carries a single request, one field per line:
+ *
+ *   source <path>          the main file to translate
+ *   arg <argument>         a compiler argument (repeated, in order)
+ *   o <path>               where to write the module (optional)
+ *   names <path>           where to write the names (optional)
+ *   spec <path>            where to write the specifications (optional)
+ *   end
+ *
+ * and is answered with `ok` or `error <message>`. The request `shutdown`
+ * stops the server. Connections are served one at a time, so a request
+ * that is not received within `timeout` seconds (unless it is 0) is
+ * answered with `error request timed out`.
+ *
+ * The parsed translation unit of every compile command (source and
+ * arguments) is kept alive between requests, along with its precompiled
+ * preamble, so translating the same file again only re-parses the main file.
+ * At most `max_units` translation units are kept. Every request is translated
+ * with `options`, if they have fragments the printed declarations of headers
+ * are shared between requests.
+ */
+int run_server(const std::string& socket_path, const char* argv0,
+               unsigned max_units, unsigned timeout,
+               const ToCoqOptions& options);
@@ -6,18 +6,24 @@
 #include <clang/AST/ASTContext.h>
 #include <clang/AST/DeclCXX.h>
 #include <clang/AST/ExprCXX.h>
+#include <clang/AST/DeclTemplate.h>
 #include <clang/AST/Mangle.h>
+#include <llvm/ADT/Hashing.h>
+#include <algorithm>
 
 #include "ClangPrinter.hpp"
 #include "CoqPrinter.hpp"
 #include "Formatter.hpp"
 #include "Logging.hpp"
+#include "SharedDefs.hpp"
 
 using namespace clang;
 
 ClangPrinter::ClangPrinter(clang::ASTContext *context)
     : context_(context), engine_(IntrusiveRefCntPtr<DiagnosticIDs>(),
-                                 IntrusiveRefCntPtr<DiagnosticOptions>()) {
+                                 IntrusiveRefCntPtr<DiagnosticOptions>()),
+      shared_(nullptr), term_fmt_(nullptr),
+      term_out_(nullptr), sorted_(nullptr), fold_(false) {
     mangleContext_ = ItaniumMangleContext::create(*context, engine_);
 }
 
@@ -26,24 +32,192 @@ ClangPrinter::getTypeSize(const BuiltinType *t) const {
     return this->context_->getTypeSize(t);
 }
 
-void
-ClangPrinter::printGlobalName(const NamedDecl *decl, CoqPrinter &print,
-                              bool raw) {
-    if (!raw) {
-        print.output() << "\"";
+llvm::StringRef
+ClangPrinter::mangledName(const NamedDecl *decl) {
+    auto key = cast<NamedDecl>(decl->getCanonicalDecl());
+    auto found = names_.find(key);
+    if (found != names_.end()) {
+        return found->second;
     }
+
+    std::string name;
+    llvm::raw_string_ostream out(name);
     if (auto fd = dyn_cast<FunctionDecl>(decl)) {
         if (fd->getLanguageLinkage() == LanguageLinkage::CLanguageLinkage) {
-            print.output() << fd->getNameAsString();
+            out << fd->getNameAsString();
         } else {
-            mangleContext_->mangleCXXName(decl, print.output().nobreak());
+            mangleContext_->mangleCXXName(decl, out);
         }
     } else {
-        mangleContext_->mangleCXXName(decl, print.output().nobreak());
+        mangleContext_->mangleCXXName(decl, out);
+    }
+    out.flush();
+
+    auto data = names_arena_.Allocate<char>(name.size());
+    std::copy(name.begin(), name.end(), data);
+    return names_[key] = llvm::StringRef(data, name.size());
+}
+
+// identifies the unnamed type `td` across translation units by its location,
+// and the specialization that it is instantiated in
+static std::string
+unnamed_identity(const TagDecl *td) {
+    auto &sm = td->getASTContext().getSourceManager();
+    auto loc = sm.getDecomposedExpansionLoc(td->getLocation());
+    std::string result;
+    llvm::raw_string_ostream out(result);
+    if (auto entry = sm.getFileEntryForID(loc.first)) {
+        out << entry->getName();
+    }
+    out << ":" << loc.second;
+    for (auto dc = td->getDeclContext(); dc; dc = dc->getParent()) {
+        auto fd = dyn_cast<FunctionDecl>(dc);
+        if (isa<ClassTemplateSpecializationDecl>(dc) ||
+            (fd && fd->isTemplateInstantiation())) {
+            out << ";";
+            cast<NamedDecl>(dc)->getNameForDiagnostic(
+                out, td->getASTContext().getPrintingPolicy(), true);
+            break;
+        }
+    }
+    return out.str();
+}
+
+// number the unnamed types of `dc` in `mangle`, `state` identifies the
+// unnamed types numbered so far and is recorded after each declaration
+static void
+number_unnamed(const DeclContext *dc, MangleContext &mangle, size_t &state,
+               llvm::DenseMap<const Decl *, size_t> &states) {
+    for (auto d : dc->decls()) {
+        // note: lambdas are numbered by the AST
+        if (auto td = dyn_cast<TagDecl>(d)) {
+            auto rd = dyn_cast<CXXRecordDecl>(td);
+            if (!td->getIdentifier() && !td->getTypedefNameForAnonDecl() &&
+                !(rd && rd->isLambda())) {
+                mangle.getAnonymousStructId(td);
+                state = llvm::hash_combine(state, unnamed_identity(td));
+            }
+        }
+        if (auto ctd = dyn_cast<ClassTemplateDecl>(d)) {
+            for (auto s : ctd->specializations()) {
+                number_unnamed(s, mangle, state, states);
+            }
+        } else if (auto ftd = dyn_cast<FunctionTemplateDecl>(d)) {
+            for (auto s : ftd->specializations()) {
+                number_unnamed(s, mangle, state, states);
+            }
+        } else if (auto inner = dyn_cast<DeclContext>(d)) {
+            number_unnamed(inner, mangle, state, states);
+        }
+        states[d] = state;
+    }
+}
+
+void
+ClangPrinter::numberUnnamedTypes() {
+    size_t state = 0;
+    unnamed_.clear();
+    number_unnamed(context_->getTranslationUnitDecl(), *mangleContext_,
+                   state, unnamed_);
+}
+
+llvm::Optional<size_t>
+ClangPrinter::unnamedTypesBefore(const Decl *decl) const {
+    auto found = unnamed_.find(decl);
+    if (found == unnamed_.end()) {
+        return llvm::None;
+    }
+    return found->second;
+}
+
+void
+ClangPrinter::printGlobalName(const NamedDecl *decl, CoqPrinter &print,
+                              bool raw) {
+    auto name = mangledName(decl);
+    if (raw) {
+        print.output() << name;
+    } else if (shared_ && shared_->sharing().names) {
+        print.output() << shared_->define("_n", "bs", "\"" + name.str() + "\"");
+    } else {
+        print.output() << "\"" << name << "\"";
+    }
+}
+
+// the inverse of `splice_indented`, `text` continues a line at `depth`
+static std::string
+unindent(llvm::StringRef text, unsigned depth) {
+    if (depth == 0) {
+        return text.str();
+    }
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        result += text[i];
+        if (text[i] == '\n') {
+            auto spaces = std::min<size_t>(depth, text.size() - i - 1);
+            while (spaces > 0 && text[i + 1] == ' ') {
+                ++i;
+                --spaces;
+            }
+        }
+    }
+    return result;
+}
+
+void
+ClangPrinter::printShared(const void *key, llvm::StringRef prefix,
+                          llvm::StringRef type, size_t min_size,
+                          CoqPrinter &print,
+                          llvm::function_ref<void(CoqPrinter &)> body) {
+    if (key) {
+        if (auto name = shared_->find(key)) {
+            print.output() << *name;
+            return;
+        }
+    }
+
+    auto &fmt = print.output();
+    if (&fmt != term_fmt_) {
+        // the outermost term is printed at depth 0, so that the text of the
+        // terms in it does not depend on where it is used
+        std::string text;
+        llvm::raw_string_ostream out(text);
+        fmt::Formatter buffer_fmt(out, 0);
+        CoqPrinter buffer(buffer_fmt);
+        auto outer_fmt = term_fmt_;
+        auto outer_out = term_out_;
+        term_fmt_ = &buffer_fmt;
+        term_out_ = &out;
+        printShared(key, prefix, type, min_size, buffer, body);
+        term_fmt_ = outer_fmt;
+        term_out_ = outer_out;
+        fmt.splice_indented(out.str());
+        return;
+    }
+
+    // note: the nested terms are defined while `body` runs, so they come
+    // before the definition of this term. the term is printed in place, so
+    // only the text of the terms that are shared is copied.
+    fmt.nobreak();
+    auto &text = term_out_->str();
+    auto start = text.size();
+    auto depth = fmt.get_depth();
+    body(print);
+    term_out_->flush();
+    if (text.size() - start < min_size) {
+        return;
+    }
+    auto term = unindent(llvm::StringRef(text).substr(start), depth);
+    if (term.size() < min_size) {
+        return;
     }
-    if (!raw) {
-        print.output() << "\"";
+    text.resize(start);
+    fmt.continue_line();
+    auto name = shared_->define(prefix, type, term);
+    if (key) {
+        shared_->remember(key, name);
     }
+    fmt << name;
 }
 
 void
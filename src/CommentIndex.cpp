@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "CommentIndex.hpp"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/DeclObjC.h"
+#include "clang/AST/DeclTemplate.h"
+#include "clang/AST/RawCommentList.h"
+#include "clang/Basic/SourceManager.h"
+#include <algorithm>
+
+using namespace clang;
+
+#if CLANG_VERSION_MAJOR >= 10
+CommentIndex::CommentIndex(const ASTContext &ctxt) : ctxt_(ctxt) {}
+
+RawComment *
+CommentIndex::comment_for(const Decl *decl) {
+    return ctxt_.getRawCommentForDeclNoCache(decl);
+}
+#else
+CommentIndex::CommentIndex(const ASTContext &ctxt) : ctxt_(ctxt) {
+    // note: clang loads the comments of precompiled headers (and preambles)
+    // the first time it looks up a comment, the translation unit is never
+    // documented so this only loads them
+    ctxt.getRawCommentForDeclNoCache(ctxt.getTranslationUnitDecl());
+
+    // the comments are sorted by location, so the comments of each file are
+    // sorted by offset
+    auto &sm = ctxt.getSourceManager();
+    for (auto c : ctxt.getRawCommentList().getComments()) {
+        auto begin = sm.getDecomposedLoc(c->getSourceRange().getBegin());
+        auto end = sm.getDecomposedLoc(c->getSourceRange().getEnd());
+        files_[begin.first].push_back(Entry{begin.second, end.second, c});
+    }
+}
+
+// the location that comments are attached to, invalid if `decl` can not
+// be documented. these are the rules of `getRawCommentForDeclNoCache`.
+static SourceLocation
+location_for_comment(const Decl *decl, const SourceManager &sm) {
+    if (decl->isImplicit()) {
+        return SourceLocation();
+    }
+    // implicit instantiations share the comment of their template
+    if (auto fd = dyn_cast<FunctionDecl>(decl)) {
+        if (fd->getTemplateSpecializationKind() == TSK_ImplicitInstantiation) {
+            return SourceLocation();
+        }
+    }
+    if (auto vd = dyn_cast<VarDecl>(decl)) {
+        if (vd->isStaticDataMember() &&
+            vd->getTemplateSpecializationKind() == TSK_ImplicitInstantiation) {
+            return SourceLocation();
+        }
+    }
+    if (auto rd = dyn_cast<CXXRecordDecl>(decl)) {
+        if (rd->getTemplateSpecializationKind() == TSK_ImplicitInstantiation) {
+            return SourceLocation();
+        }
+    }
+    if (auto sd = dyn_cast<ClassTemplateSpecializationDecl>(decl)) {
+        auto kind = sd->getSpecializationKind();
+        if (kind == TSK_ImplicitInstantiation || kind == TSK_Undeclared) {
+            return SourceLocation();
+        }
+    }
+    if (auto ed = dyn_cast<EnumDecl>(decl)) {
+        if (ed->getTemplateSpecializationKind() == TSK_ImplicitInstantiation) {
+            return SourceLocation();
+        }
+    }
+    // a tag that is only declared as part of another declaration, e.g.
+    // `struct S *p;`, is not documented
+    if (auto td = dyn_cast<TagDecl>(decl)) {
+        if (td->isEmbeddedInDeclarator() && !td->isCompleteDefinition()) {
+            return SourceLocation();
+        }
+    }
+    if (isa<ParmVarDecl>(decl) || isa<TemplateTypeParmDecl>(decl) ||
+        isa<NonTypeTemplateParmDecl>(decl) ||
+        isa<TemplateTemplateParmDecl>(decl)) {
+        return SourceLocation();
+    }
+
+    if (isa<ObjCMethodDecl>(decl) || isa<ObjCContainerDecl>(decl) ||
+        isa<ObjCPropertyDecl>(decl) || isa<RedeclarableTemplateDecl>(decl) ||
+        isa<ClassTemplateSpecializationDecl>(decl)) {
+        return decl->getSourceRange().getBegin();
+    }
+    auto loc = decl->getLocation();
+    if (loc.isMacroID()) {
+        if (isa<TypedefDecl>(decl)) {
+            return decl->getSourceRange().getBegin();
+        } else if (auto td = dyn_cast<TagDecl>(decl)) {
+            // the name of the tag is an argument of a macro that defines it
+            if (sm.isMacroArgExpansion(loc) && td->isCompleteDefinition()) {
+                return sm.getExpansionLoc(loc);
+            }
+        }
+    }
+    return loc;
+}
+
+RawComment *
+CommentIndex::comment_for(const Decl *decl) {
+    auto &sm = ctxt_.getSourceManager();
+    auto loc = location_for_comment(decl, sm);
+    if (loc.isInvalid() || !loc.isFileID()) {
+        return nullptr;
+    }
+    auto all = ctxt_.getLangOpts().CommentOpts.ParseAllComments;
+    auto at = sm.getDecomposedLoc(loc);
+    auto &comments = files_[at.first];
+    auto after = std::lower_bound(
+        comments.begin(), comments.end(), at.second,
+        [](const Entry &e, unsigned offset) { return e.begin < offset; });
+
+    // a trailing comment on the same line documents members and variables
+    if (after != comments.end() &&
+        (after->comment->isDocumentation() || all) &&
+        after->comment->isTrailingComment() &&
+        (isa<FieldDecl>(decl) || isa<EnumConstantDecl>(decl) ||
+         isa<VarDecl>(decl) || isa<ObjCMethodDecl>(decl) ||
+         isa<ObjCPropertyDecl>(decl)) &&
+        sm.getLineNumber(at.first, at.second) ==
+            sm.getLineNumber(at.first, after->begin)) {
+        return after->comment;
+    }
+
+    // otherwise the comment before the declaration, if there is nothing
+    // but whitespace (and other tokens of the declaration) in between
+    if (after == comments.begin()) {
+        return nullptr;
+    }
+    auto before = std::prev(after);
+    if (!(before->comment->isDocumentation() || all) ||
+        before->comment->isTrailingComment() || before->end > at.second) {
+        return nullptr;
+    }
+    bool invalid = false;
+    auto buffer = sm.getBufferData(at.first, &invalid);
+    if (invalid) {
+        return nullptr;
+    }
+    auto text = buffer.substr(before->end, at.second - before->end);
+    if (text.find_first_of(";{}#@") != StringRef::npos) {
+        return nullptr;
+    }
+    return before->comment;
+}
+#endif
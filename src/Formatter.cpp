@@ -15,6 +15,9 @@ Formatter::Formatter() : Formatter(llvm::outs()) {}
 Formatter::Formatter(llvm::raw_ostream& _out)
     : out(_out), depth(0), spaces(0), blank(true) {}
 
+Formatter::Formatter(llvm::raw_ostream& _out, unsigned int _depth)
+    : out(_out), depth(_depth), spaces(0), blank(false) {}
+
 llvm::raw_ostream&
 Formatter::line() {
     out << "\n";
@@ -53,6 +56,45 @@ Formatter::outdent() {
     this->depth -= 2;
 }
 
+void
+Formatter::splice(llvm::StringRef text) {
+    if (text.empty()) {
+        return;
+    }
+    // pending spaces are dropped at the end of a line
+    if (text.front() == '\n') {
+        out << text;
+        spaces = 0;
+    } else {
+        nobreak() << text;
+    }
+    blank = text.back() == '\n';
+}
+
+void
+Formatter::splice_indented(llvm::StringRef text) {
+    if (depth == 0) {
+        splice(text);
+        return;
+    }
+    // note: empty lines are not indented
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        result += text[i];
+        if (text[i] == '\n' && i + 1 < text.size() && text[i + 1] != '\n') {
+            result.append(depth, ' ');
+        }
+    }
+    splice(result);
+}
+
+void
+Formatter::continue_line() {
+    blank = false;
+    spaces = 0;
+}
+
 void
 Formatter::ascii(int val) {
     out << "\"";
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "FragmentCache.hpp"
+#include "ModuleBuilder.hpp"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/ODRHash.h"
+#include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/Version.inc"
+#include "clang/Lex/Lexer.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+std::string
+FragmentCache::context_key(const ASTContext &ctxt) {
+    std::string result;
+    llvm::raw_string_ostream out(result);
+    out << ctxt.getTargetInfo().getTriple().str() << ";";
+    auto &opts = ctxt.getLangOpts();
+#define LANGOPT(Name, Bits, Default, Description) out << opts.Name << ",";
+#define ENUM_LANGOPT(Name, Type, Bits, Default, Description)                  \
+    out << static_cast<unsigned>(opts.get##Name()) << ",";
+#include "clang/Basic/LangOptions.def"
+    return out.str();
+}
+
+std::string
+FragmentCache::fingerprint(const Decl *decl, llvm::StringRef context_key,
+                           unsigned depth, size_t unnamed) {
+    // note: instantiations are identified by their template arguments, which
+    // are not part of the ODR hash
+    auto nd = dyn_cast<NamedDecl>(decl);
+    if (context_key.empty() || nd == nullptr || is_instantiated(decl)) {
+        return "";
+    }
+
+    ODRHash odr;
+    if (auto fd = dyn_cast<FunctionDecl>(decl)) {
+        odr.AddFunctionDecl(fd);
+    } else if (auto rd = dyn_cast<CXXRecordDecl>(decl)) {
+        if (rd->isThisDeclarationADefinition()) {
+            odr.AddCXXRecordDecl(rd);
+        }
+    } else if (auto ed = dyn_cast<EnumDecl>(decl)) {
+#if CLANG_VERSION_MAJOR >= 9
+        if (ed->isThisDeclarationADefinition()) {
+            odr.AddEnumDecl(ed);
+        }
+#else
+        return "";
+#endif
+    } else if (isa<TypedefNameDecl>(decl) || isa<VarDecl>(decl)) {
+        odr.AddSubDecl(decl);
+    } else {
+        return "";
+    }
+
+    auto &ctxt = decl->getASTContext();
+    auto text = Lexer::getSourceText(
+        CharSourceRange::getTokenRange(decl->getSourceRange()),
+        ctxt.getSourceManager(), ctxt.getLangOpts());
+
+    llvm::MD5 hash;
+    hash.update(context_key);
+    hash.update(decl->getDeclKindName());
+    hash.update(";");
+    hash.update(nd->getQualifiedNameAsString());
+    hash.update(";");
+    hash.update(std::to_string(odr.CalculateHash()));
+    hash.update(";");
+    hash.update(std::to_string(depth));
+    hash.update(";");
+    hash.update(std::to_string(unnamed));
+    hash.update(";");
+    hash.update(text);
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> str;
+    llvm::MD5::stringifyResult(result, str);
+    return str.str().str();
+}
+
+bool
+FragmentCache::lookup(llvm::StringRef key, std::string &text) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = fragments_.find(key);
+    if (found == fragments_.end()) {
+        return false;
+    }
+    text = found->second;
+    return true;
+}
+
+void
+FragmentCache::insert(llvm::StringRef key, llvm::StringRef text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fragments_.try_emplace(key, text.str());
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "HeaderLibrary.hpp"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include <ctype.h>
+
+static std::string
+digest(llvm::MD5 &hash) {
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> digest;
+    llvm::MD5::stringifyResult(result, digest);
+    return digest.substr(0, 8).str();
+}
+
+std::string
+HeaderLibraries::prefix(llvm::StringRef header,
+                        llvm::StringRef variant) const {
+    // headers with the same name in different directories (or printed with
+    // different options) are told apart by the hash of their path and options
+    llvm::MD5 hash;
+    hash.update(header);
+    hash.update(llvm::StringRef("\0", 1));
+    hash.update(variant);
+
+    std::string name = "hdr_";
+    for (auto c : llvm::sys::path::filename(header)) {
+        name += isalnum(c) ? c : '_';
+    }
+    name += "_";
+    name += digest(hash);
+    return name;
+}
+
+std::string
+HeaderLibraries::module_name(llvm::StringRef prefix,
+                             llvm::StringRef contents) const {
+    llvm::MD5 hash;
+    hash.update(contents);
+    return (prefix + "_" + digest(hash)).str();
+}
+
+std::string
+HeaderLibraries::path(llvm::StringRef module) const {
+    llvm::SmallString<256> result(dir_);
+    llvm::sys::path::append(result, module + ".v");
+    return result.str().str();
+}
+
+bool
+HeaderLibraries::claim(llvm::StringRef module) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return claimed_.insert(module.str()).second;
+}
@@ -4,17 +4,35 @@
  * SPDX-License-Identifier:AGPL-3.0-or-later
  */
 #include "Logging.hpp"
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/CrashRecoveryContext.h>
 #include <llvm/Support/raw_ostream.h>
 
 namespace logging {
 static Level log_level = Level::NONE;
 
+namespace {
+// discards everything, without a buffer so that it can be shared by the
+// workers of -j (`llvm::nulls()` is buffered)
+class NullStream : public llvm::raw_ostream {
+public:
+    NullStream() : llvm::raw_ostream(/*unbuffered=*/true) {}
+
+private:
+    void write_impl(const char *, size_t) override {}
+    uint64_t current_pos() const override {
+        return 0;
+    }
+};
+}
+
 llvm::raw_ostream&
 log(Level level) {
+    static NullStream nulls;
     if (level < log_level) {
         return llvm::errs();
     } else {
-        return llvm::nulls();
+        return nulls;
     }
 }
 
@@ -25,8 +43,16 @@ set_level(Level level) {
 
 [[noreturn]] void
 die() {
-    llvm::outs().flush();
     llvm::errs().flush();
+    // a worker of -j only fails its own translation unit
+    if (auto crc = llvm::CrashRecoveryContext::GetCurrent()) {
+#if LLVM_VERSION_MAJOR >= 11
+        crc->HandleExit(1);
+#else
+        crc->HandleCrash();
+#endif
+    }
+    llvm::outs().flush();
     exit(1);
 }
-}
\ No newline at end of file
+}
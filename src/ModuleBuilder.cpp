@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier:AGPL-3.0-or-later
  */
+#include "CommentIndex.hpp"
 #include "CommentScanner.hpp"
 #include "DeclVisitorWithArgs.h"
 #include "Filter.hpp"
@@ -15,10 +16,11 @@ using namespace clang;
 
 class BuildModule : public ConstDeclVisitorArgs<BuildModule, void, bool> {
 private:
-    ::Module &module_;
+    DeclSink &module_;
     Filter &filter_;
-    SpecCollector &specs_;
+    SpecCollector *const specs_;
     clang::ASTContext *const context_;
+    CommentIndex comments_;
 
 private:
     Filter::What go(const NamedDecl *decl, bool definition = true) {
@@ -41,9 +43,10 @@ private:
     }
 
 public:
-    BuildModule(::Module &m, Filter &filter, clang::ASTContext *context,
-                SpecCollector &specs)
-        : module_(m), filter_(filter), specs_(specs), context_(context) {}
+    BuildModule(DeclSink &m, Filter &filter, clang::ASTContext *context,
+                SpecCollector *specs)
+        : module_(m), filter_(filter), specs_(specs), context_(context),
+          comments_(*context) {}
 
     void VisitDecl(const Decl *d, bool) {
         logging::log() << "visiting declaration..." << d->getDeclKindName()
@@ -101,8 +104,10 @@ public:
         using namespace comment;
         auto defn = decl->getDefinition();
         if (defn == decl) {
-            if (auto c = context_->getRawCommentForDeclNoCache(decl)) {
-                this->specs_.add_specification(decl, c, *context_);
+            if (specs_) {
+                if (auto c = comments_.comment_for(decl)) {
+                    specs_->add_specification(decl, c, *context_);
+                }
             }
 
             if (go(decl, true) >= Filter::What::DEFINITION) {
@@ -195,28 +200,66 @@ public:
 };
 
 void
-build_module(const clang::TranslationUnitDecl *tu, ::Module &mod,
-             Filter &filter, SpecCollector &specs) {
+build_module(const clang::TranslationUnitDecl *tu, DeclSink &mod,
+             Filter &filter, SpecCollector *specs) {
     auto &ctxt = tu->getASTContext();
     BuildModule(mod, filter, &ctxt, specs).VisitTranslationUnitDecl(tu, false);
 }
 
+int
+defines(const clang::NamedDecl *d) {
+    if (auto vd = dyn_cast<VarDecl>(d)) {
+        if (vd->getInit()) {
+            return 2;
+        }
+        if (vd->isThisDeclarationADefinition() != VarDecl::DeclarationOnly) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// add `d` to `decls` unless it is already there, replacing the redeclaration
+// that is there if `d` defines more
+static void
+add_unique(std::vector<const clang::NamedDecl *> &decls,
+           llvm::DenseMap<const clang::Decl *, size_t> &index,
+           const clang::NamedDecl *d) {
+    auto found =
+        index.insert(std::make_pair(d->getCanonicalDecl(), decls.size()));
+    if (found.second) {
+        decls.push_back(d);
+    } else if (defines(d) > defines(decls[found.first->second])) {
+        decls[found.first->second] = d;
+    }
+}
+
 void ::Module::add_definition(const clang::NamedDecl *d, bool opaque) {
     if (opaque) {
         add_declaration(d);
     } else {
-        std::string name = d->getNameAsString();
-        auto found = definitions_.find(name);
-        if ((found == definitions_.end()) || found->second != d) {
-            definitions_.insert(std::make_pair(name, d));
-        }
+        add_unique(definitions_, defined_, d);
     }
 }
 
 void ::Module::add_declaration(const clang::NamedDecl *d) {
-    std::string name = d->getNameAsString();
-    auto found = imports_.find(name);
-    if ((found == imports_.end()) || found->second.first != d) {
-        imports_.insert(std::make_pair(name, std::make_pair(d, true)));
+    add_unique(imports_, imported_, d);
+}
+
+bool
+is_instantiated(const clang::Decl *decl) {
+    if (auto fd = dyn_cast<FunctionDecl>(decl)) {
+        if (fd->isTemplateInstantiation() ||
+            fd->isFunctionTemplateSpecialization()) {
+            return true;
+        }
+    }
+    for (auto dc = dyn_cast<DeclContext>(decl) ? dyn_cast<DeclContext>(decl)
+                                               : decl->getDeclContext();
+         dc != nullptr; dc = dc->getParent()) {
+        if (isa<ClassTemplateSpecializationDecl>(dc)) {
+            return true;
+        }
     }
+    return false;
 }
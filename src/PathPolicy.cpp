@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "PathPolicy.hpp"
+#include "clang/AST/Decl.h"
+#include "clang/Basic/FileManager.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+bool
+PathRules::add(bool include, Kind kind, llvm::StringRef pattern) {
+    Rule rule{include, kind, "", llvm::None};
+    if (kind == Kind::Path) {
+        auto glob = llvm::GlobPattern::create(pattern);
+        if (!glob) {
+            llvm::consumeError(glob.takeError());
+            return false;
+        }
+        rule.glob.emplace(std::move(*glob));
+    } else {
+        rule.prefix = pattern.str();
+    }
+    rules_.push_back(std::move(rule));
+    text_ += include ? "+" : "-";
+    text_ += kind == Kind::Path ? "path " : "ns ";
+    text_ += pattern;
+    text_ += ";";
+    return true;
+}
+
+bool
+PathRules::read(llvm::StringRef file) {
+    auto buffer = llvm::MemoryBuffer::getFile(file);
+    if (!buffer) {
+        llvm::errs() << "Failed to open filter file: " << file << "\n"
+                     << buffer.getError().message() << "\n";
+        return false;
+    }
+    llvm::SmallVector<llvm::StringRef, 32> lines;
+    (*buffer)->getBuffer().split(lines, '\n');
+    unsigned number = 0;
+    for (auto line : lines) {
+        ++number;
+        line = line.trim();
+        if (line.empty() || line.startswith("#")) {
+            continue;
+        }
+        auto rule = line.split(' ');
+        auto pattern = rule.second.trim();
+        bool ok = false;
+        if (!pattern.empty()) {
+            if (rule.first == "+path" || rule.first == "-path") {
+                ok = add(rule.first[0] == '+', Kind::Path, pattern);
+            } else if (rule.first == "+ns" || rule.first == "-ns") {
+                ok = add(rule.first[0] == '+', Kind::Namespace, pattern);
+            }
+        }
+        if (!ok) {
+            llvm::errs() << file << ":" << number
+                         << ": malformed filter rule: " << line << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+llvm::Optional<bool>
+PathRules::match(Kind kind, llvm::StringRef str) const {
+    for (auto i = rules_.rbegin(), e = rules_.rend(); i != e; ++i) {
+        if (i->kind != kind) {
+            continue;
+        }
+        if (kind == Kind::Path) {
+            if (i->glob->match(str)) {
+                return i->include;
+            }
+        } else if (str == i->prefix ||
+                   (str.startswith(i->prefix) &&
+                    str.substr(i->prefix.size()).startswith("::"))) {
+            return i->include;
+        }
+    }
+    return llvm::None;
+}
+
+bool
+PathPolicy::excluded(FileID file) {
+    auto found = files_.find(file);
+    if (found != files_.end()) {
+        return found->second;
+    }
+    bool result = false;
+    if (auto entry = sm_.getFileEntryForID(file)) {
+        auto verdict = rules_.match(PathRules::Kind::Path, entry->getName());
+        // note: the same header can be reached through different spellings
+        // of its path, so the real path is also checked
+        if (!verdict.hasValue() && !entry->tryGetRealPathName().empty()) {
+            verdict = rules_.match(PathRules::Kind::Path,
+                                   entry->tryGetRealPathName());
+        }
+        result = verdict.hasValue() && !*verdict;
+    }
+    files_[file] = result;
+    return result;
+}
+
+bool
+PathPolicy::excluded(const DeclContext *dc) {
+    // the declarations of a namespace share the verdict of the namespace
+    while (dc && !isa<NamespaceDecl>(dc) && !isa<TranslationUnitDecl>(dc)) {
+        dc = dc->getParent();
+    }
+    auto ns = dyn_cast_or_null<NamespaceDecl>(dc);
+    if (ns == nullptr) {
+        return false;
+    }
+    auto found = namespaces_.find(ns);
+    if (found != namespaces_.end()) {
+        return found->second;
+    }
+    auto verdict = rules_.match(PathRules::Kind::Namespace,
+                                ns->getQualifiedNameAsString());
+    bool result = verdict.hasValue() ? !*verdict : excluded(ns->getParent());
+    namespaces_[ns] = result;
+    return result;
+}
+
+Filter::What
+PathPolicy::shouldInclude(const Decl *d) {
+    auto loc = d->getLocation();
+    if (loc.isValid() && excluded(sm_.getFileID(sm_.getExpansionLoc(loc)))) {
+        return What::NOTHING;
+    }
+    if (excluded(d->getDeclContext())) {
+        return What::NOTHING;
+    }
+    return What::DEFINITION;
+}
@@ -8,6 +8,7 @@
 #include "DeclVisitorWithArgs.h"
 #include "Formatter.hpp"
 #include "Logging.hpp"
+#include "SortedModule.hpp"
 #include "clang/AST/Decl.h"
 #include "clang/AST/RecordLayout.h"
 
@@ -155,6 +156,52 @@ printDestructor(const CXXDestructorDecl *decl, CoqPrinter &print,
     }
 }
 
+// the text printed by `f`, continuing the current line of `print`
+template<typename F>
+static std::string
+print_text(CoqPrinter &print, F f) {
+    std::string text;
+    llvm::raw_string_ostream out(text);
+    fmt::Formatter fmt(out, print.output().get_depth());
+    CoqPrinter buffer(fmt);
+    f(buffer);
+    return out.str();
+}
+
+// print the declaration `(kind <name> <args>)` of `key`. when printing a
+// sorted module it is added to `table` as the entry `<name> := (value <args>)`
+// instead.
+template<typename N, typename F>
+static void
+print_decl(const char *kind, SortedModule::Table table, const char *value,
+           llvm::StringRef key, CoqPrinter &print, ClangPrinter &cprint,
+           N name, F args) {
+    if (auto sorted = cprint.getSorted()) {
+        auto name_text = print_text(print, name);
+        sorted->add(table, key, std::move(name_text),
+                    print_text(print, [&](CoqPrinter &print) {
+                        print.ctor(value, false);
+                        args(print);
+                        print.end_ctor();
+                    }));
+        return;
+    }
+    print.ctor(kind);
+    name(print);
+    args(print);
+    print.end_ctor();
+}
+
+template<typename F>
+static void
+print_decl(const char *kind, SortedModule::Table table, const char *value,
+           const NamedDecl *decl, CoqPrinter &print, ClangPrinter &cprint,
+           F args) {
+    print_decl(kind, table, value, cprint.mangledName(decl), print, cprint,
+               [&](CoqPrinter &print) { cprint.printGlobalName(decl, print); },
+               args);
+}
+
 class PrintDecl :
     public ConstDeclVisitorArgs<PrintDecl, bool, CoqPrinter &, ClangPrinter &,
                                 const ASTContext &> {
@@ -191,10 +238,15 @@ public:
 
     bool VisitTypedefNameDecl(const TypedefNameDecl *type, CoqPrinter &print,
                               ClangPrinter &cprint, const ASTContext &) {
-        print.ctor("Dtypedef")
-            << "\"" << type->getNameAsString() << "\"" << fmt::nbsp;
-        cprint.printQualType(type->getUnderlyingType(), print);
-        print.end_ctor();
+        // note: typedefs are keyed by their unqualified name
+        auto name = type->getNameAsString();
+        print_decl(
+            "Dtypedef", SortedModule::Globals, "Gtypedef", name, print, cprint,
+            [&](CoqPrinter &print) { print.str(name); },
+            [&](CoqPrinter &print) {
+                print.output() << fmt::nbsp;
+                cprint.printQualType(type->getUnderlyingType(), print);
+            });
         return true;
     }
 
@@ -211,6 +263,36 @@ public:
         return true;
     }
 
+    // the definitions of records are optional in their declarations
+    // (`Dstruct n (Some s)`) but not in their entries (`Gstruct s`), and the
+    // other way around for the `value` of a constant (`Dconstant n t e` and
+    // `Gconstant t (Some e)`)
+    void beginDefinition(CoqPrinter &print, ClangPrinter &cprint,
+                         bool value = false) {
+        if ((cprint.getSorted() != nullptr) == value) {
+            print.ctor("Some", false);
+        }
+    }
+
+    void endDefinition(CoqPrinter &print, ClangPrinter &cprint,
+                       bool value = false) {
+        if ((cprint.getSorted() != nullptr) == value) {
+            print.end_ctor();
+        }
+    }
+
+    // a record without a definition, e.g. `(Dstruct "name" None)`
+    void printUndefined(const char *kind, const CXXRecordDecl *decl,
+                        CoqPrinter &print, ClangPrinter &cprint) {
+        print_decl(kind, SortedModule::Globals, "Gtype", decl, print, cprint,
+                   [&](CoqPrinter &print) {
+                       if (!cprint.getSorted()) {
+                           print.output() << fmt::nbsp;
+                           print.none();
+                       }
+                   });
+    }
+
     bool printFields(const CXXRecordDecl *decl, const ASTRecordLayout &layout,
                      CoqPrinter &print, ClangPrinter &cprint) {
         auto i = 0;
@@ -234,28 +316,27 @@ public:
         assert(decl->getTagKind() == TagTypeKind::TTK_Union);
 
         const auto &layout = ctxt.getASTRecordLayout(decl);
-        print.ctor("Dunion");
-
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::nbsp;
         if (!decl->isCompleteDefinition()) {
-            print.output() << "None" << fmt::rparen;
+            printUndefined("Dunion", decl, print, cprint);
             return true;
         }
 
-        print.ctor("Some", false);
+        print_decl("Dunion", SortedModule::Globals, "Gunion", decl, print,
+                   cprint, [&](CoqPrinter &print) {
+                       print.output() << fmt::nbsp;
+                       beginDefinition(print, cprint);
 
-        print.begin_record();
-        print.record_field("u_fields");
-        printFields(decl, layout, print, cprint);
+                       print.begin_record();
+                       print.record_field("u_fields");
+                       printFields(decl, layout, print, cprint);
 
-        print.output() << fmt::line
-                       << " ; u_size := " << layout.getSize().getQuantity()
-                       << fmt::nbsp;
+                       print.output()
+                           << fmt::line << " ; u_size := "
+                           << layout.getSize().getQuantity() << fmt::nbsp;
 
-        print.end_record();
-        print.end_ctor();
-        print.end_ctor();
+                       print.end_record();
+                       endDefinition(print, cprint);
+                   });
         return true;
     }
 
@@ -264,73 +345,76 @@ public:
         assert(decl->getTagKind() == TagTypeKind::TTK_Class ||
                decl->getTagKind() == TagTypeKind::TTK_Struct);
         auto &layout = ctxt.getASTRecordLayout(decl);
-        print.ctor("Dstruct");
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::nbsp;
         if (!decl->isCompleteDefinition()) {
-            print.output() << "None" << fmt::rparen;
+            printUndefined("Dstruct", decl, print, cprint);
             return true;
         }
 
-        print.ctor("Some", false);
+        print_decl("Dstruct", SortedModule::Globals, "Gstruct", decl, print,
+                   cprint, [&](CoqPrinter &print) {
+            print.output() << fmt::nbsp;
+            beginDefinition(print, cprint);
 
-        // print the base classes
-        print.output() << fmt::line << "{| s_bases :=" << fmt::nbsp;
-        print.begin_list();
-        for (auto base : decl->bases()) {
-            if (base.isVirtual()) {
-                logging::unsupported()
-                    << "virtual base classes not supported\n";
+            // print the base classes
+            print.output() << fmt::line << "{| s_bases :=" << fmt::nbsp;
+            print.begin_list();
+            for (auto base : decl->bases()) {
+                if (base.isVirtual()) {
+                    logging::unsupported()
+                        << "virtual base classes not supported\n";
+                }
+
+                auto rec = base.getType().getTypePtr()->getAsCXXRecordDecl();
+                if (rec) {
+                    print.output() << "(";
+                    cprint.printGlobalName(rec, print);
+                    print.output()
+                        << ", {| li_offset :="
+                        << layout.getBaseClassOffset(rec).getQuantity()
+                        << "|})";
+                } else {
+                    using namespace logging;
+                    fatal() << "base class is not a RecordType at "
+                            << cprint.sourceRange(decl->getSourceRange())
+                            << "\n";
+                    die();
+                }
+                print.cons();
             }
+            print.end_list();
 
-            auto rec = base.getType().getTypePtr()->getAsCXXRecordDecl();
-            if (rec) {
-                print.output() << "(";
-                cprint.printGlobalName(rec, print);
-                print.output()
-                    << ", {| li_offset :="
-                    << layout.getBaseClassOffset(rec).getQuantity() << "|})";
+            // print the fields
+            print.output() << fmt::line << " ; s_fields :=" << fmt::indent
+                           << fmt::line;
+            printFields(decl, layout, print, cprint);
+            print.output() << fmt::outdent << fmt::line;
+
+            // print the layout information
+            print.output() << fmt::line << " ; s_layout :=" << fmt::nbsp;
+            if (decl->isPOD()) {
+                print.output() << "POD";
+            } else if (decl->isStandardLayout()) {
+                print.output() << "Standard";
             } else {
-                using namespace logging;
-                fatal() << "base class is not a RecordType at "
-                        << cprint.sourceRange(decl->getSourceRange()) << "\n";
-                die();
+                print.output() << "Unspecified";
             }
-            print.cons();
-        }
-        print.end_list();
-
-        // print the fields
-        print.output() << fmt::line << " ; s_fields :=" << fmt::indent
-                       << fmt::line;
-        printFields(decl, layout, print, cprint);
-        print.output() << fmt::outdent << fmt::line;
-
-        // print the layout information
-        print.output() << fmt::line << " ; s_layout :=" << fmt::nbsp;
-        if (decl->isPOD()) {
-            print.output() << "POD";
-        } else if (decl->isStandardLayout()) {
-            print.output() << "Standard";
-        } else {
-            print.output() << "Unspecified";
-        }
 
-        print.output() << fmt::line
-                       << " ; s_size := " << layout.getSize().getQuantity();
+            print.output() << fmt::line
+                           << " ; s_size := " << layout.getSize().getQuantity();
 
-        // todo(gmm): i need to print any implicit declarations.
+            // todo(gmm): i need to print any implicit declarations.
 
-        print.output() << "|}" << fmt::rparen << fmt::rparen;
+            print.output() << "|}";
+            endDefinition(print, cprint);
+        });
         return true;
     }
 
     bool VisitCXXRecordDecl(const CXXRecordDecl *decl, CoqPrinter &print,
                             ClangPrinter &cprint, const ASTContext &ctxt) {
         if (!decl->isCompleteDefinition()) {
-            print.ctor("Dtype");
-            cprint.printGlobalName(decl, print);
-            print.end_ctor();
+            print_decl("Dtype", SortedModule::Globals, "Gtype", decl, print,
+                       cprint, [](CoqPrinter &) {});
         } else {
             switch (decl->getTagKind()) {
             case TagTypeKind::TTK_Class:
@@ -354,170 +438,178 @@ public:
 
     bool VisitFunctionDecl(const FunctionDecl *decl, CoqPrinter &print,
                            ClangPrinter &cprint, const ASTContext &) {
-        print.ctor("Dfunction");
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::line;
-        printFunction(decl, print, cprint);
-        print.end_ctor();
+        print_decl("Dfunction", SortedModule::Symbols, "Ofunction", decl, print,
+                   cprint, [&](CoqPrinter &print) {
+                       print.output() << fmt::line;
+                       printFunction(decl, print, cprint);
+                   });
         return true;
     }
 
     bool VisitCXXMethodDecl(const CXXMethodDecl *decl, CoqPrinter &print,
                             ClangPrinter &cprint, const ASTContext &) {
         if (decl->isStatic()) {
-            print.ctor("Dfunction");
-            cprint.printGlobalName(decl, print);
-            print.output() << fmt::line << fmt::indent;
-            printFunction(decl, print, cprint);
-            print.output() << fmt::outdent;
-            print.end_ctor();
+            print_decl("Dfunction", SortedModule::Symbols, "Ofunction", decl,
+                       print, cprint, [&](CoqPrinter &print) {
+                           print.output() << fmt::line << fmt::indent;
+                           printFunction(decl, print, cprint);
+                           print.output() << fmt::outdent;
+                       });
         } else {
-            print.ctor("Dmethod");
-            cprint.printGlobalName(decl, print);
-            print.output() << fmt::line << fmt::indent;
-            printMethod(decl, print, cprint);
-            print.output() << fmt::outdent;
-            print.end_ctor();
+            print_decl("Dmethod", SortedModule::Symbols, "Omethod", decl,
+                       print, cprint, [&](CoqPrinter &print) {
+                           print.output() << fmt::line << fmt::indent;
+                           printMethod(decl, print, cprint);
+                           print.output() << fmt::outdent;
+                       });
         }
         return true;
     }
 
     bool VisitEnumConstantDecl(const EnumConstantDecl *decl, CoqPrinter &print,
                                ClangPrinter &cprint, const ASTContext &) {
-        print.ctor("Dconstant");
         assert((decl != nullptr) && (!decl->getNameAsString().empty()));
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::nbsp;
-        cprint.printQualType(decl->getType(), print);
-        print.output() << fmt::nbsp;
-        if (decl->getInitExpr()) {
-            cprint.printExpr(decl->getInitExpr(), print);
-        } else {
-            print.ctor("Eint") << decl->getInitVal() << fmt::nbsp;
-            cprint.printQualType(decl->getType(), print);
-            print.output() << fmt::rparen;
-        }
-        print.end_ctor();
+        print_decl(
+            "Dconstant", SortedModule::Globals, "Gconstant", decl, print,
+            cprint, [&](CoqPrinter &print) {
+                print.output() << fmt::nbsp;
+                cprint.printQualType(decl->getType(), print);
+                print.output() << fmt::nbsp;
+                beginDefinition(print, cprint, true);
+                if (decl->getInitExpr() && !cprint.getFold()) {
+                    cprint.printExpr(decl->getInitExpr(), print);
+                } else if (cprint.getFold()) {
+                    cprint.printValue(decl->getInitVal(), decl->getType(),
+                                      print);
+                } else {
+                    print.ctor("Eint") << decl->getInitVal() << fmt::nbsp;
+                    cprint.printQualType(decl->getType(), print);
+                    print.output() << fmt::rparen;
+                }
+                endDefinition(print, cprint, true);
+            });
         return true;
     }
 
     bool VisitCXXConstructorDecl(const CXXConstructorDecl *decl,
                                  CoqPrinter &print, ClangPrinter &cprint,
                                  const ASTContext &) {
-        print.ctor("Dconstructor");
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::line;
-        print.output() << "{| c_class :=" << fmt::nbsp;
-        cprint.printGlobalName(decl->getParent(), print);
-        print.output() << fmt::line << " ; c_params :=" << fmt::nbsp;
-
-        for (auto i : decl->parameters()) {
-            cprint.printParam(i, print);
-            print.output() << "::";
-        }
-        print.output() << "nil";
-
-        print.output() << fmt::line << " ; c_body :=" << fmt::nbsp;
-        if (decl->getBody()) {
-            print.output() << "Some" << fmt::nbsp;
-            print.ctor("UserDefined");
-            print.begin_tuple();
-
-            // print the initializer list
-            // todo(gmm): parent constructors are defaulted if they are not listed,
-            //   i need to make sure that everything ends up in the list, and in the right order
-            print.begin_list();
-            for (auto init : decl->inits()) {
-                print.begin_record();
-                print.record_field("init_path");
-                if (init->isMemberInitializer()) {
-                    print.ctor("Field")
-                        << "\"" << init->getMember()->getNameAsString() << "\"";
-                    print.end_ctor();
-                } else if (init->isBaseInitializer()) {
-                    print.ctor("Base");
-                    cprint.printGlobalName(
-                        init->getBaseClass()->getAsCXXRecordDecl(), print);
-                    print.end_ctor();
-                } else if (init->isIndirectMemberInitializer()) {
-                    auto im = init->getIndirectMember();
-                    print.ctor("Indirect");
-
-                    bool completed = false;
-                    print.begin_list();
-                    for (auto i : im->chain()) {
-                        if (i->getName() == "") {
-                            if (const FieldDecl *field =
-                                    dyn_cast<FieldDecl>(i)) {
-                                print.begin_tuple();
-                                printMangledFieldName(field, print, cprint);
-                                print.next_tuple();
-                                cprint.printGlobalName(
-                                    field->getType()->getAsCXXRecordDecl(),
-                                    print);
-                                print.end_tuple();
-                                print.cons();
+        print_decl("Dconstructor", SortedModule::Symbols, "Oconstructor", decl,
+                   print, cprint, [&](CoqPrinter &print) {
+            print.output() << fmt::line;
+            print.output() << "{| c_class :=" << fmt::nbsp;
+            cprint.printGlobalName(decl->getParent(), print);
+            print.output() << fmt::line << " ; c_params :=" << fmt::nbsp;
+
+            for (auto i : decl->parameters()) {
+                cprint.printParam(i, print);
+                print.output() << "::";
+            }
+            print.output() << "nil";
+
+            print.output() << fmt::line << " ; c_body :=" << fmt::nbsp;
+            if (decl->getBody()) {
+                print.output() << "Some" << fmt::nbsp;
+                print.ctor("UserDefined");
+                print.begin_tuple();
+
+                // print the initializer list
+                // todo(gmm): parent constructors are defaulted if they are not listed,
+                //   i need to make sure that everything ends up in the list, and in the right order
+                print.begin_list();
+                for (auto init : decl->inits()) {
+                    print.begin_record();
+                    print.record_field("init_path");
+                    if (init->isMemberInitializer()) {
+                        print.ctor("Field")
+                            << "\"" << init->getMember()->getNameAsString()
+                            << "\"";
+                        print.end_ctor();
+                    } else if (init->isBaseInitializer()) {
+                        print.ctor("Base");
+                        cprint.printGlobalName(
+                            init->getBaseClass()->getAsCXXRecordDecl(), print);
+                        print.end_ctor();
+                    } else if (init->isIndirectMemberInitializer()) {
+                        auto im = init->getIndirectMember();
+                        print.ctor("Indirect");
+
+                        bool completed = false;
+                        print.begin_list();
+                        for (auto i : im->chain()) {
+                            if (i->getName() == "") {
+                                if (const FieldDecl *field =
+                                        dyn_cast<FieldDecl>(i)) {
+                                    print.begin_tuple();
+                                    printMangledFieldName(field, print, cprint);
+                                    print.next_tuple();
+                                    cprint.printGlobalName(
+                                        field->getType()->getAsCXXRecordDecl(),
+                                        print);
+                                    print.end_tuple();
+                                    print.cons();
+                                } else {
+                                    assert(false && "indirect field decl "
+                                                    "contains non FieldDecl");
+                                }
                             } else {
-                                assert(false && "indirect field decl contains "
-                                                "non FieldDecl");
+                                completed = true;
+                                print.end_list();
+                                print.output() << fmt::nbsp;
+                                print.str(i->getName());
+                                break;
                             }
-                        } else {
-                            completed = true;
-                            print.end_list();
-                            print.output() << fmt::nbsp;
-                            print.str(i->getName());
-                            break;
                         }
-                    }
-                    assert(completed && "didn't find a named field");
+                        assert(completed && "didn't find a named field");
 
-                    print.end_ctor();
-                } else if (init->isDelegatingInitializer()) {
-                    print.output() << "This";
-                } else {
-                    assert(false && "unknown initializer type");
-                }
-                print.output() << ";" << fmt::nbsp;
-                print.record_field("init_type");
-                if (init->getMember()) {
-                    cprint.printQualType(init->getMember()->getType(), print);
-                } else if (init->getIndirectMember()) {
-                    cprint.printQualType(init->getIndirectMember()->getType(),
-                                         print);
-                } else if (init->getBaseClass()) {
-                    cprint.printType(init->getBaseClass(), print);
-                } else if (init->isDelegatingInitializer()) {
-                    cprint.printQualType(decl->getThisType(), print);
-                } else {
-                    assert(false && "not member, base class, or indirect");
+                        print.end_ctor();
+                    } else if (init->isDelegatingInitializer()) {
+                        print.output() << "This";
+                    } else {
+                        assert(false && "unknown initializer type");
+                    }
+                    print.output() << ";" << fmt::nbsp;
+                    print.record_field("init_type");
+                    if (init->getMember()) {
+                        cprint.printQualType(init->getMember()->getType(),
+                                             print);
+                    } else if (init->getIndirectMember()) {
+                        cprint.printQualType(
+                            init->getIndirectMember()->getType(), print);
+                    } else if (init->getBaseClass()) {
+                        cprint.printType(init->getBaseClass(), print);
+                    } else if (init->isDelegatingInitializer()) {
+                        cprint.printQualType(decl->getThisType(), print);
+                    } else {
+                        assert(false && "not member, base class, or indirect");
+                    }
+                    print.output() << ";" << fmt::nbsp;
+                    print.record_field("init_init");
+                    cprint.printExpr(init->getInit(), print);
+                    print.end_record();
+                    print.cons();
                 }
-                print.output() << ";" << fmt::nbsp;
-                print.record_field("init_init");
-                cprint.printExpr(init->getInit(), print);
-                print.end_record();
-                print.cons();
+                print.end_list();
+                print.next_tuple();
+                cprint.printStmt(decl->getBody(), print);
+                print.end_tuple();
+                print.end_ctor();
+            } else {
+                print.none();
             }
-            print.end_list();
-            print.next_tuple();
-            cprint.printStmt(decl->getBody(), print);
-            print.end_tuple();
-            print.end_ctor();
-        } else {
-            print.none();
-        }
-        print.output() << "|}";
-        print.end_ctor();
+            print.output() << "|}";
+        });
         return true;
     }
 
     bool VisitCXXDestructorDecl(const CXXDestructorDecl *decl,
                                 CoqPrinter &print, ClangPrinter &cprint,
                                 const ASTContext &ctxt) {
-        print.ctor("Ddestructor");
-        cprint.printGlobalName(decl, print);
-        print.output() << fmt::line;
-        printDestructor(decl, print, cprint);
-        print.end_ctor();
+        print_decl("Ddestructor", SortedModule::Symbols, "Odestructor", decl,
+                   print, cprint, [&](CoqPrinter &print) {
+                       print.output() << fmt::line;
+                       printDestructor(decl, print, cprint);
+                   });
         return true;
     }
 
@@ -525,35 +617,45 @@ public:
                       ClangPrinter &cprint, const ASTContext &) {
         if (decl->isConstexpr()) {
             if (decl->hasInit()) {
-                print.ctor("Dconstant");
-                cprint.printGlobalName(decl, print);
-                print.output() << fmt::nbsp;
-                cprint.printQualType(decl->getType(), print);
-                print.output() << fmt::nbsp;
-                cprint.printExpr(decl->getInit(), print);
+                print_decl("Dconstant", SortedModule::Globals, "Gconstant",
+                           decl, print, cprint, [&](CoqPrinter &print) {
+                               print.output() << fmt::nbsp;
+                               cprint.printQualType(decl->getType(), print);
+                               print.output() << fmt::nbsp;
+                               beginDefinition(print, cprint, true);
+                               if (!cprint.printFolded(decl->getInit(),
+                                                       print)) {
+                                   cprint.printExpr(decl->getInit(), print);
+                               }
+                               endDefinition(print, cprint, true);
+                           });
             } else { //no initializer
-                print.ctor("Dconstant_undef");
-                cprint.printGlobalName(decl, print);
-                print.output() << fmt::nbsp;
-                cprint.printQualType(decl->getType(), print);
+                print_decl("Dconstant_undef", SortedModule::Globals,
+                           "Gconstant", decl, print, cprint,
+                           [&](CoqPrinter &print) {
+                               print.output() << fmt::nbsp;
+                               cprint.printQualType(decl->getType(), print);
+                               if (cprint.getSorted()) {
+                                   print.output() << fmt::nbsp;
+                                   print.none();
+                               }
+                           });
             }
-            print.end_ctor();
         } else if (decl->isTemplated()) {
             return false;
         } else {
-            print.ctor("Dvar");
-
-            cprint.printGlobalName(decl, print);
-            print.output() << fmt::nbsp;
-            cprint.printQualType(decl->getType(), print);
-            if (decl->hasInit()) {
-                print.some();
-                cprint.printExpr(decl->getInit(), print);
-                print.output() << fmt::rparen;
-            } else {
-                print.none();
-            }
-            print.end_ctor();
+            print_decl("Dvar", SortedModule::Symbols, "Ovar", decl, print,
+                       cprint, [&](CoqPrinter &print) {
+                           print.output() << fmt::nbsp;
+                           cprint.printQualType(decl->getType(), print);
+                           if (decl->hasInit()) {
+                               print.some();
+                               cprint.printExpr(decl->getInit(), print);
+                               print.output() << fmt::rparen;
+                           } else {
+                               print.none();
+                           }
+                       });
         }
         return true;
     }
@@ -584,8 +686,43 @@ public:
         return false;
     }
 
+    // the entries that `Denum` adds: the enumeration, if its underlying
+    // type is known, and a constant for each enumerator
+    void addEnumEntries(const EnumDecl *decl, SortedModule &sorted,
+                        CoqPrinter &print, ClangPrinter &cprint) {
+        auto name = print_text(print, [&](CoqPrinter &print) {
+            cprint.printGlobalName(decl, print);
+        });
+        auto enum_ty = "(Tnamed " + name + ")";
+        auto raw_ty = enum_ty;
+        auto t = decl->getIntegerType();
+        if (!t.isNull()) {
+            raw_ty = print_text(print, [&](CoqPrinter &print) {
+                cprint.printQualType(t, print);
+            });
+            std::string branches;
+            for (auto i : decl->enumerators()) {
+                branches += "\"" + i->getNameAsString() + "\" :: ";
+            }
+            sorted.add(SortedModule::Globals, cprint.mangledName(decl), name,
+                       "(Genum " + raw_ty + " (" + branches + "nil))");
+        }
+        for (auto i : decl->enumerators()) {
+            auto branch = i->getNameAsString();
+            sorted.add(SortedModule::Globals, branch, "\"" + branch + "\"",
+                       "(Gconstant " + enum_ty + " (Some (Eint (" +
+                           std::to_string(i->getInitVal().getExtValue()) +
+                           ")%Z " + raw_ty + ")))");
+        }
+    }
+
     bool VisitEnumDecl(const EnumDecl *decl, CoqPrinter &print,
                        ClangPrinter &cprint, const ASTContext &) {
+        if (auto sorted = cprint.getSorted()) {
+            addEnumEntries(decl, *sorted, print, cprint);
+            return false;
+        }
+
         print.ctor("Denum");
         cprint.printGlobalName(decl, print);
         print.output() << fmt::nbsp;
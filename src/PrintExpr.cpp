@@ -7,15 +7,22 @@
 #include "CoqPrinter.hpp"
 #include "Formatter.hpp"
 #include "Logging.hpp"
+#include "SharedDefs.hpp"
 #include "clang/AST/Decl.h"
 #include "clang/AST/Mangle.h"
 #include "clang/AST/StmtVisitor.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/Version.inc"
+#include "llvm/ADT/APSInt.h"
+#include <vector>
 
 using namespace clang;
 using namespace fmt;
 
+// initializer lists of integer literals with at least this many elements
+// are printed as one string
+static const unsigned DENSE_INIT_LIST = 16;
+
 void
 printCastKind(Formatter& out, const CastKind ck) {
     if (ck == CastKind::CK_LValueToRValue) {
@@ -154,7 +161,8 @@ public:
         }
     }
 
-    void VisitBinaryOperator(const BinaryOperator* expr, CoqPrinter& print,
+    // print the constructor of `expr` up to its left operand
+    void beginBinaryOperator(const BinaryOperator* expr, CoqPrinter& print,
                              ClangPrinter& cprint, const ASTContext& ctxt) {
 #define ACASE(k, v)                                                            \
     case BinaryOperatorKind::BO_##k##Assign:                                   \
@@ -193,10 +201,29 @@ public:
             break;
         }
 #undef ACASE
-        cprint.printExpr(expr->getLHS(), print);
-        print.output() << fmt::nbsp;
-        cprint.printExpr(expr->getRHS(), print);
-        done(expr, print, cprint);
+    }
+
+    void VisitBinaryOperator(const BinaryOperator* expr, CoqPrinter& print,
+                             ClangPrinter& cprint, const ASTContext& ctxt) {
+        // note: chains such as `a + b + c + ...` or `a || b || ...` nest to
+        // the left, so the operators along the left spine are printed in a
+        // loop rather than by recursion. they are not shared on their own
+        // (with -share-terms), only the whole chain is.
+        std::vector<const BinaryOperator*> spine;
+        const Expr* leaf = expr;
+        while (auto bo = dyn_cast<BinaryOperator>(leaf)) {
+            spine.push_back(bo);
+            leaf = bo->getLHS();
+        }
+        for (auto bo : spine) {
+            beginBinaryOperator(bo, print, cprint, ctxt);
+        }
+        cprint.printExpr(leaf, print);
+        for (auto i = spine.rbegin(), e = spine.rend(); i != e; ++i) {
+            print.output() << fmt::nbsp;
+            cprint.printExpr((*i)->getRHS(), print);
+            done(*i, print, cprint);
+        }
     }
 
     void VisitDependentScopeDeclRefExpr(const DependentScopeDeclRefExpr* expr,
@@ -404,17 +431,7 @@ public:
     void VisitStringLiteral(const StringLiteral* lit, CoqPrinter& print,
                             ClangPrinter& cprint, const ASTContext&) {
         print.ctor("Estring", false);
-        for (auto i = lit->getBytes().begin(), end = lit->getBytes().end();
-             i != end; ++i) {
-            char buf[25];
-            sprintf(buf, "Byte.x%02x", (unsigned)*i);
-            print.output() << "(String " << buf << " ";
-        }
-        print.output() << "EmptyString";
-        for (auto i = lit->getBytes().begin(), end = lit->getBytes().end();
-             i != end; ++i) {
-            print.output() << ")";
-        }
+        print.bytes(lit->getBytes());
         done(lit, print, cprint);
     }
 
@@ -569,8 +586,128 @@ public:
         this->Visit(e->getSubExpr(), print, cprint, ctxt);
     }
 
+    void printArrayFiller(const InitListExpr* expr, CoqPrinter& print,
+                          ClangPrinter& cprint) {
+        if (expr->getArrayFiller()) {
+            print.some();
+            cprint.printExpr(expr->getArrayFiller(), print);
+            print.end_ctor();
+        } else {
+            print.none();
+        }
+    }
+
+    // the shapes of the elements of an array that is printed as one string
+    enum class Dense { None, Chars, Ints, CastInts };
+
+    // the values of the elements of `expr` if they all print to the same
+    // term but for the value: `Echar v elem`, `Eint v elem` or (for integer
+    // literals that are implicitly converted) `Ecast Cintegral (Rvalue,
+    // Eint v from) elem`. the types must be the same, including their sugar.
+    Dense getDenseElements(const InitListExpr* expr, QualType& elem,
+                           QualType& from, std::vector<std::string>& values) {
+        if (expr->getNumInits() == 0) {
+            return Dense::None;
+        }
+        Dense shape = Dense::None;
+        values.reserve(expr->getNumInits());
+        for (auto i : expr->inits()) {
+            Dense kind = Dense::None;
+            const Expr* lit = i;
+            if (auto ice = dyn_cast<ImplicitCastExpr>(i)) {
+                if (ice->getCastKind() != CastKind::CK_IntegralCast ||
+                    !isa<IntegerLiteral>(ice->getSubExpr())) {
+                    return Dense::None;
+                }
+                kind = Dense::CastInts;
+                lit = ice->getSubExpr();
+            } else if (isa<IntegerLiteral>(i)) {
+                kind = Dense::Ints;
+            } else if (isa<CharacterLiteral>(i)) {
+                kind = Dense::Chars;
+            } else {
+                return Dense::None;
+            }
+
+            if (shape == Dense::None) {
+                shape = kind;
+                elem = i->getType();
+                from = lit->getType();
+            } else if (kind != shape || i->getType() != elem ||
+                       lit->getType() != from) {
+                return Dense::None;
+            }
+
+            if (auto c = dyn_cast<CharacterLiteral>(lit)) {
+                values.push_back(std::to_string(c->getValue()));
+            } else {
+                auto il = cast<IntegerLiteral>(lit);
+                values.push_back(il->getValue().toString(
+                    10, il->getType()->isSignedIntegerOrEnumerationType()));
+            }
+        }
+        return shape;
+    }
+
+    // print a large array of literals as one string, which parser.v expands
+    // to the same elements: arrays of bytes become `Einitlist_blob` and
+    // other arrays `Einitlist_chars`, `Einitlist_ints` or
+    // `Einitlist_cast_ints`
+    bool printDenseInitList(const InitListExpr* expr, CoqPrinter& print,
+                            ClangPrinter& cprint, const ASTContext& ctxt) {
+        QualType elem, from;
+        std::vector<std::string> values;
+        if (expr->getNumInits() < DENSE_INIT_LIST) {
+            return false;
+        }
+        auto shape = getDenseElements(expr, elem, from, values);
+        if (shape == Dense::None) {
+            return false;
+        }
+
+        // note: a negative character is printed as a large unsigned value,
+        // which is not a byte
+        std::string data;
+        bool bytes = shape == Dense::Chars && ctxt.getTypeSize(elem) == 8;
+        for (auto i = expr->inits().begin(); bytes && i != expr->inits().end();
+             ++i) {
+            auto value = cast<CharacterLiteral>(*i)->getValue();
+            bytes = value < 256;
+            data += static_cast<char>(value);
+        }
+        if (bytes) {
+            print.ctor("Einitlist_blob");
+        } else {
+            data.clear();
+            for (auto& v : values) {
+                if (&v != &values.front()) {
+                    data += " ";
+                }
+                data += v;
+            }
+            const char* ctor = shape == Dense::Chars ? "Einitlist_chars"
+                               : shape == Dense::Ints ? "Einitlist_ints"
+                                                      : "Einitlist_cast_ints";
+            print.ctor(ctor);
+        }
+        print.bytes(data) << fmt::nbsp;
+        if (shape == Dense::CastInts) {
+            cprint.printQualType(from, print);
+            print.output() << fmt::nbsp;
+        }
+        cprint.printQualType(elem, print);
+        print.output() << fmt::nbsp;
+        printArrayFiller(expr, print, cprint);
+        done(expr, print, cprint);
+        return true;
+    }
+
     void VisitInitListExpr(const InitListExpr* expr, CoqPrinter& print,
-                           ClangPrinter& cprint, const ASTContext&) {
+                           ClangPrinter& cprint, const ASTContext& ctxt) {
+        if (printDenseInitList(expr, print, cprint, ctxt)) {
+            return;
+        }
+
         print.ctor("Einitlist");
 
         print.begin_list();
@@ -580,13 +717,7 @@ public:
         }
         print.end_list() << fmt::nbsp;
 
-        if (expr->getArrayFiller()) {
-            print.some();
-            cprint.printExpr(expr->getArrayFiller(), print);
-            print.end_ctor();
-        } else {
-            print.none();
-        }
+        printArrayFiller(expr, print, cprint);
 
         done(expr, print, cprint);
     }
@@ -607,6 +738,10 @@ public:
     void VisitUnaryExprOrTypeTraitExpr(const UnaryExprOrTypeTraitExpr* expr,
                                        CoqPrinter& print, ClangPrinter& cprint,
                                        const ASTContext& ctxt) {
+        if (cprint.printFolded(expr, print)) {
+            return;
+        }
+
         auto do_arg = [&print, &cprint, &ctxt, expr]() {
             if (expr->isArgumentType()) {
                 print.ctor("inl", false);
@@ -816,7 +951,7 @@ public:
     void VisitPredefinedExpr(const PredefinedExpr* expr, CoqPrinter& print,
                              ClangPrinter& cprint, const ASTContext&) {
         print.ctor("Estring");
-        print.str(expr->getFunctionName()->getString());
+        print.bytes(expr->getFunctionName()->getBytes());
         done(expr, print, cprint);
     }
 
@@ -881,7 +1016,15 @@ PrintExpr PrintExpr::printer;
 void
 ClangPrinter::printExpr(const clang::Expr* expr, CoqPrinter& print) {
     auto depth = print.output().get_depth();
-    PrintExpr::printer.Visit(expr, print, *this, *this->context_);
+    if (shared_ && shared_->sharing().terms) {
+        printShared(nullptr, "_e", "Expr", shared_->sharing().terms, print,
+                    [&](CoqPrinter& buffer) {
+                        PrintExpr::printer.Visit(expr, buffer, *this,
+                                                 *this->context_);
+                    });
+    } else {
+        PrintExpr::printer.Visit(expr, print, *this, *this->context_);
+    }
     if (depth != print.output().get_depth()) {
         using namespace logging;
         fatal() << "indentation bug in during: " << expr->getStmtClassName()
@@ -889,3 +1032,46 @@ ClangPrinter::printExpr(const clang::Expr* expr, CoqPrinter& print) {
         assert(false);
     }
 }
+
+void
+ClangPrinter::printValue(const llvm::APSInt& value, const clang::QualType& type,
+                         CoqPrinter& print) {
+    if (type->isBooleanType()) {
+        print.output() << (value.getBoolValue() ? "(Ebool true)"
+                                                : "(Ebool false)");
+        return;
+    }
+    print.ctor("Eint", false);
+    if (value.isNegative()) {
+        print.output() << "(" << value.toString(10) << ")%Z";
+    } else if (value.isSigned()) {
+        print.output() << value.toString(10) << "%Z";
+    } else {
+        print.output() << value.toString(10);
+    }
+    print.output() << fmt::nbsp;
+    printQualType(type, print);
+    print.end_ctor();
+}
+
+bool
+ClangPrinter::printFolded(const clang::Expr* expr, CoqPrinter& print) {
+    if (!fold_ || expr->isValueDependent() ||
+        !expr->getType()->isIntegralOrEnumerationType()) {
+        return false;
+    }
+#if CLANG_VERSION_MAJOR >= 8
+    Expr::EvalResult result;
+    if (!expr->EvaluateAsInt(result, *context_)) {
+        return false;
+    }
+    printValue(result.Val.getInt(), expr->getType(), print);
+#else
+    llvm::APSInt value;
+    if (!expr->EvaluateAsInt(value, *context_)) {
+        return false;
+    }
+    printValue(value, expr->getType(), print);
+#endif
+    return true;
+}
@@ -7,6 +7,7 @@
 #include "CoqPrinter.hpp"
 #include "Formatter.hpp"
 #include "Logging.hpp"
+#include "SharedDefs.hpp"
 #include "clang/AST/Mangle.h"
 #include "clang/AST/StmtVisitor.h"
 #include "clang/AST/Type.h"
@@ -14,6 +15,7 @@
 #if CLANG_VERSION_MAJOR >= 10
 #include "clang/AST/Attr.h"
 #endif
+#include <vector>
 
 using namespace clang;
 
@@ -159,25 +161,36 @@ public:
 
     void VisitIfStmt(const IfStmt *stmt, CoqPrinter &print,
                      ClangPrinter &cprint, ASTContext &) {
-        print.ctor("Sif");
-        if (auto v = stmt->getConditionVariable()) {
-            print.some();
-            cprint.printLocalDecl(v, print);
-            print.end_ctor();
-        } else {
-            print.none();
+        // note: `else if` ladders nest in the else branches, so they are
+        // printed in a loop rather than by recursion (and the nested `if`s
+        // are not shared on their own)
+        unsigned depth = 0;
+        const Stmt *last = stmt;
+        while (auto s = dyn_cast_or_null<IfStmt>(last)) {
+            print.ctor("Sif");
+            if (auto v = s->getConditionVariable()) {
+                print.some();
+                cprint.printLocalDecl(v, print);
+                print.end_ctor();
+            } else {
+                print.none();
+            }
+            print.output() << fmt::nbsp;
+            cprint.printExpr(s->getCond(), print);
+            print.output() << fmt::nbsp;
+            cprint.printStmt(s->getThen(), print);
+            print.output() << fmt::nbsp;
+            last = s->getElse();
+            ++depth;
         }
-        print.output() << fmt::nbsp;
-        cprint.printExpr(stmt->getCond(), print);
-        print.output() << fmt::nbsp;
-        cprint.printStmt(stmt->getThen(), print);
-        print.output() << fmt::nbsp;
-        if (stmt->getElse()) {
-            cprint.printStmt(stmt->getElse(), print);
+        if (last) {
+            cprint.printStmt(last, print);
         } else {
             print.output() << "Sskip";
         }
-        print.end_ctor();
+        for (; depth > 0; --depth) {
+            print.end_ctor();
+        }
     }
 
     void VisitCaseStmt(const CaseStmt *stmt, CoqPrinter &print,
@@ -243,12 +256,8 @@ public:
     void VisitCompoundStmt(const CompoundStmt *stmt, CoqPrinter &print,
                            ClangPrinter &cprint, ASTContext &) {
         print.ctor("Sseq");
-        print.begin_list();
-        for (auto i : stmt->body()) {
-            cprint.printStmt(i, print);
-            print.cons();
-        }
-        print.end_list();
+        std::vector<const Stmt *> body(stmt->body_begin(), stmt->body_end());
+        cprint.printStmtList(body, print);
         print.end_ctor();
     }
 
@@ -345,6 +354,80 @@ PrintStmt PrintStmt::printer;
 void
 ClangPrinter::printStmt(const clang::Stmt *stmt, CoqPrinter &print) {
     auto depth = print.output().get_depth();
-    PrintStmt::printer.Visit(stmt, print, *this, *this->context_);
+    unsigned min_size = 0;
+    bool block = false;
+    if (shared_) {
+        min_size = shared_->sharing().terms;
+        auto blocks = shared_->sharing().blocks;
+        if (blocks != 0 && isa<CompoundStmt>(stmt) &&
+            (min_size == 0 || blocks < min_size)) {
+            min_size = blocks;
+            block = true;
+        }
+    }
+    if (min_size != 0) {
+        printShared(nullptr, block ? "_b" : "_s", "Stmt", min_size, print,
+                    [&](CoqPrinter &buffer) {
+                        PrintStmt::printer.Visit(stmt, buffer, *this,
+                                                 *this->context_);
+                    });
+    } else {
+        PrintStmt::printer.Visit(stmt, print, *this, *this->context_);
+    }
     assert(depth == print.output().get_depth());
 }
+
+void
+ClangPrinter::printStmtList(llvm::ArrayRef<const clang::Stmt *> stmts,
+                            CoqPrinter &print) {
+    unsigned blocks = shared_ ? shared_->sharing().blocks : 0;
+    if (blocks == 0) {
+        print.begin_list();
+        for (auto i : stmts) {
+            printStmt(i, print);
+            print.cons();
+        }
+        print.end_list();
+        return;
+    }
+
+    // note: a block with many small statements, e.g. the body of a switch
+    // statement, is not bounded by outlining the blocks in it. the
+    // statements are printed in order (defining their own blocks) and the
+    // list is then cut from the end, so a segment is `s :: ... :: _l<n>`.
+    std::vector<std::string> texts(stmts.size());
+    for (size_t i = 0; i < stmts.size(); ++i) {
+        llvm::raw_string_ostream out(texts[i]);
+        fmt::Formatter fmt(out, 0);
+        CoqPrinter buffer(fmt);
+        printStmt(stmts[i], buffer);
+    }
+    auto segment = [&](CoqPrinter &out, size_t begin, size_t end,
+                       const std::string &tail) {
+        out.begin_list();
+        for (size_t i = begin; i < end; ++i) {
+            out.output().splice_indented(texts[i]);
+            out.cons();
+        }
+        out.output() << tail << fmt::rparen;
+    };
+    std::string tail = "nil";
+    size_t end = texts.size();
+    size_t size = 0;
+    for (size_t i = texts.size(); i > 1; --i) {
+        size += texts[i - 1].size();
+        if (size >= blocks) {
+            std::string text;
+            {
+                llvm::raw_string_ostream out(text);
+                fmt::Formatter fmt(out, 0);
+                CoqPrinter buffer(fmt);
+                segment(buffer, i - 1, end, tail);
+            }
+            tail = shared_->define("_l", "list Stmt", text);
+            end = i - 1;
+            size = 0;
+        }
+    }
+    segment(print, 0, end, tail);
+}
@@ -6,6 +6,7 @@
 #include "ClangPrinter.hpp"
 #include "CoqPrinter.hpp"
 #include "Logging.hpp"
+#include "SharedDefs.hpp"
 #include "TypeVisitorWithArgs.h"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
@@ -223,21 +224,21 @@ public:
     void VisitLValueReferenceType(const LValueReferenceType* type,
                                   CoqPrinter& print, ClangPrinter& cprint) {
         print.ctor("Treference");
-        printQualType(type->getPointeeType(), print, cprint);
+        cprint.printQualType(type->getPointeeType(), print);
         print.end_ctor();
     }
 
     void VisitRValueReferenceType(const RValueReferenceType* type,
                                   CoqPrinter& print, ClangPrinter& cprint) {
         print.ctor("Trv_reference");
-        printQualType(type->getPointeeType(), print, cprint);
+        cprint.printQualType(type->getPointeeType(), print);
         print.end_ctor();
     }
 
     void VisitPointerType(const PointerType* type, CoqPrinter& print,
                           ClangPrinter& cprint) {
         print.ctor("Tpointer");
-        printQualType(type->getPointeeType(), print, cprint);
+        cprint.printQualType(type->getPointeeType(), print);
         print.end_ctor();
     }
 
@@ -254,11 +255,11 @@ public:
     void VisitFunctionProtoType(const FunctionProtoType* type,
                                 CoqPrinter& print, ClangPrinter& cprint) {
         print.ctor("Tfunction");
-        printQualType(type->getReturnType(), print, cprint);
+        cprint.printQualType(type->getReturnType(), print);
         print.output() << fmt::nbsp;
         print.begin_list();
         for (auto i : type->param_types()) {
-            printQualType(i, print, cprint);
+            cprint.printQualType(i, print);
             print.cons();
         }
         print.end_list();
@@ -268,13 +269,13 @@ public:
 
     void VisitElaboratedType(const ElaboratedType* type, CoqPrinter& print,
                              ClangPrinter& cprint) {
-        printQualType(type->getNamedType(), print, cprint);
+        cprint.printQualType(type->getNamedType(), print);
     }
 
     void VisitConstantArrayType(const ConstantArrayType* type,
                                 CoqPrinter& print, ClangPrinter& cprint) {
         print.ctor("Tarray");
-        printQualType(type->getElementType(), print, cprint);
+        cprint.printQualType(type->getElementType(), print);
         print.output() << fmt::nbsp << type->getSize().getLimitedValue()
                        << fmt::rparen;
     }
@@ -282,7 +283,7 @@ public:
     void VisitSubstTemplateTypeParmType(const SubstTemplateTypeParmType* type,
                                         CoqPrinter& print,
                                         ClangPrinter& cprint) {
-        printQualType(type->getReplacementType(), print, cprint);
+        cprint.printQualType(type->getReplacementType(), print);
     }
 
     void VisitIncompleteArrayType(const IncompleteArrayType* type,
@@ -290,7 +291,7 @@ public:
         // note(gmm): i might want to note the sugar.
         print.ctor("Qconst");
         print.ctor("Tpointer", false);
-        printQualType(type->getElementType(), print, cprint);
+        cprint.printQualType(type->getElementType(), print);
         print.output() << fmt::rparen << fmt::rparen;
     }
 
@@ -298,7 +299,7 @@ public:
                           ClangPrinter& cprint) {
         print.ctor("Qconst");
         print.ctor("Tpointer", false);
-        printQualType(type->getPointeeType(), print, cprint);
+        cprint.printQualType(type->getPointeeType(), print);
         print.output() << fmt::rparen << fmt::rparen;
     }
 
@@ -347,6 +348,10 @@ public:
 
 PrintType PrintType::printer;
 
+// shorter types, e.g. `(Qmut T_int32)`, are repeated rather than named since
+// the name would not be much shorter
+static const size_t SHARED_TYPE_SIZE = 16;
+
 void
 ClangPrinter::printType(const clang::Type* type, CoqPrinter& print) {
     auto depth = print.output().get_depth();
@@ -357,7 +362,15 @@ ClangPrinter::printType(const clang::Type* type, CoqPrinter& print) {
 void
 ClangPrinter::printQualType(const QualType& qt, CoqPrinter& print) {
     auto depth = print.output().get_depth();
-    ::printQualType(qt, print, *this);
+    if (shared_ && shared_->sharing().types) {
+        // note: the pointer includes the local qualifiers
+        printShared(qt.getAsOpaquePtr(), "_t", "type", SHARED_TYPE_SIZE, print,
+                    [&](CoqPrinter& buffer) {
+                        ::printQualType(qt, buffer, *this);
+                    });
+    } else {
+        ::printQualType(qt, print, *this);
+    }
     assert(depth == print.output().get_depth());
 }
 
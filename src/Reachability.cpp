@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "Reachability.hpp"
+#include "Logging.hpp"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/AST/ExprCXX.h"
+#include "clang/AST/RecursiveASTVisitor.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+namespace {
+
+// computes the declarations that are reachable from a set of roots
+class Reachable : public RecursiveASTVisitor<Reachable> {
+public:
+    using Base = RecursiveASTVisitor<Reachable>;
+
+    bool shouldVisitTemplateInstantiations() const {
+        return true;
+    }
+
+    bool shouldVisitImplicitCode() const {
+        return true;
+    }
+
+    void reach(const Decl *d) {
+        if (d == nullptr) {
+            return;
+        }
+        // local variables are printed as part of their function
+        if (auto vd = dyn_cast<VarDecl>(d)) {
+            if (vd->isLocalVarDeclOrParm() && !vd->isStaticLocal()) {
+                return;
+            }
+        }
+        d = d->getCanonicalDecl();
+        if (reached_.insert(d).second) {
+            work_.push_back(d);
+        }
+    }
+
+    bool contains(const Decl *d) const {
+        return reached_.count(d->getCanonicalDecl()) != 0;
+    }
+
+    void run() {
+        while (!work_.empty()) {
+            auto d = work_.back();
+            work_.pop_back();
+            follow(d);
+        }
+    }
+
+public:
+    bool TraverseType(QualType t) {
+        if (t.isNull() || !types_.insert(t.getTypePtr()).second) {
+            return true;
+        }
+        return Base::TraverseType(t);
+    }
+
+    bool VisitType(Type *t) {
+        reach(t->getAsTagDecl());
+        return true;
+    }
+
+    bool VisitTypedefType(TypedefType *t) {
+        reach(t->getDecl());
+        return true;
+    }
+
+    bool VisitExpr(Expr *e) {
+        // note: the printer prints the type of every expression
+        TraverseType(e->getType());
+        return true;
+    }
+
+    bool VisitDeclRefExpr(DeclRefExpr *e) {
+        reach(e->getDecl());
+        return true;
+    }
+
+    bool VisitMemberExpr(MemberExpr *e) {
+        reach(e->getMemberDecl());
+        return true;
+    }
+
+    bool VisitCXXConstructExpr(CXXConstructExpr *e) {
+        reach(e->getConstructor());
+        return true;
+    }
+
+    bool VisitCXXNewExpr(CXXNewExpr *e) {
+        reach(e->getOperatorNew());
+        reach(e->getOperatorDelete());
+        return true;
+    }
+
+    bool VisitCXXDeleteExpr(CXXDeleteExpr *e) {
+        reach(e->getOperatorDelete());
+        TraverseType(e->getDestroyedType());
+        return true;
+    }
+
+    bool VisitVarDecl(VarDecl *d) {
+        if (d->isStaticLocal()) {
+            reach(d);
+        }
+        return true;
+    }
+
+private:
+    // reach the declarations that `d` refers to
+    void follow(const Decl *d) {
+        if (auto rd = dyn_cast<CXXRecordDecl>(d)) {
+            // note: the members of a record are only reached when they are
+            // used, except for its destructor
+            rd = rd->getDefinition();
+            if (rd == nullptr) {
+                return;
+            }
+            for (auto &b : rd->bases()) {
+                TraverseType(b.getType());
+            }
+            for (auto f : rd->fields()) {
+                TraverseType(f->getType());
+            }
+            reach(rd->getDestructor());
+        } else if (auto ed = dyn_cast<EnumDecl>(d)) {
+            TraverseType(ed->getIntegerType());
+            for (auto i : ed->enumerators()) {
+                reach(i);
+            }
+        } else if (auto ecd = dyn_cast<EnumConstantDecl>(d)) {
+            reach(dyn_cast<Decl>(ecd->getDeclContext()));
+            TraverseStmt(const_cast<Expr *>(ecd->getInitExpr()));
+        } else if (auto td = dyn_cast<TypedefNameDecl>(d)) {
+            TraverseType(td->getUnderlyingType());
+        } else if (auto fd = dyn_cast<FunctionDecl>(d)) {
+            if (auto md = dyn_cast<CXXMethodDecl>(fd)) {
+                reach(md->getParent());
+            }
+            if (auto def = fd->getDefinition()) {
+                fd = def;
+            }
+            TraverseDecl(const_cast<FunctionDecl *>(fd));
+        } else if (auto vd = dyn_cast<VarDecl>(d)) {
+            if (auto def = vd->getDefinition()) {
+                vd = def;
+            }
+            TraverseDecl(const_cast<VarDecl *>(vd));
+        } else if (auto field = dyn_cast<FieldDecl>(d)) {
+            reach(field->getParent());
+        }
+    }
+
+private:
+    llvm::DenseSet<const Decl *> reached_;
+    llvm::DenseSet<const Type *> types_;
+    std::vector<const Decl *> work_;
+};
+
+} // namespace
+
+void
+PruningSink::flush(DeclSink &sink) {
+    Reachable reachable;
+    std::vector<bool> matched(roots_.size(), false);
+    for (auto &f : found_) {
+        auto d = f.decl;
+        if (roots_.empty()) {
+            auto &sm = d->getASTContext().getSourceManager();
+            if (sm.isInMainFile(sm.getExpansionLoc(d->getLocation()))) {
+                reachable.reach(d);
+            }
+            continue;
+        }
+        auto name = d->getQualifiedNameAsString();
+        for (size_t i = 0; i < roots_.size(); ++i) {
+            if (roots_[i] == name) {
+                matched[i] = true;
+                reachable.reach(d);
+            }
+        }
+    }
+    // a misspelled root would silently produce an empty module
+    for (size_t i = 0; i < roots_.size(); ++i) {
+        if (!matched[i]) {
+            llvm::errs() << "Warning: no declaration is named " << roots_[i]
+                         << ", it is not a root\n";
+        }
+    }
+    reachable.run();
+
+    unsigned kept = 0;
+    for (auto &f : found_) {
+        if (!reachable.contains(f.decl)) {
+            continue;
+        }
+        ++kept;
+        if (f.definition) {
+            sink.add_definition(f.decl, f.opaque);
+        } else {
+            sink.add_declaration(f.decl);
+        }
+    }
+    logging::log() << "kept " << kept << " of " << found_.size()
+                   << " declarations\n";
+    found_.clear();
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "SharedDefs.hpp"
+#include "Formatter.hpp"
+
+std::string
+SharedDefs::define(llvm::StringRef prefix, llvm::StringRef type,
+                   llvm::StringRef term) {
+    // note: the type is part of the key because the same text can have
+    // different types, e.g. a name and a string literal
+    std::string key = type.str();
+    key += '\0';
+    key += term;
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        return defs_[found->second].name;
+    }
+    index_[key] = defs_.size();
+    defs_.push_back(Def{prefix.str() + std::to_string(defs_.size()),
+                        type.str(), term.str()});
+    return defs_.back().name;
+}
+
+void
+SharedDefs::write(fmt::Formatter& fmt) const {
+    for (auto& d : defs_) {
+        fmt << "Local Definition " << d.name << " : " << d.type << " :=";
+        if (llvm::StringRef(d.term).contains('\n')) {
+            fmt << fmt::indent << fmt::line;
+            // terms are printed at depth 0 as if they continued a line, so
+            // they may start a new line
+            fmt.splice_indented(llvm::StringRef(d.term).ltrim());
+            fmt << "." << fmt::outdent << fmt::line;
+        } else {
+            fmt << fmt::nbsp << d.term << "." << fmt::line;
+        }
+    }
+}
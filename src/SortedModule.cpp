@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "SortedModule.hpp"
+#include "CoqPrinter.hpp"
+#include <algorithm>
+
+void
+SortedModule::add(Table table, llvm::StringRef key, std::string name,
+                  std::string value) {
+    tables_[table].push_back(
+        Entry{key.str(), std::move(name), std::move(value)});
+}
+
+unsigned
+SortedModule::write_tree(llvm::ArrayRef<const Entry*> entries,
+                         CoqPrinter& print) {
+    if (entries.empty()) {
+        print.output() << "Rleaf";
+        return 0;
+    }
+    auto mid = entries.size() / 2;
+    print.ctor("Rnode");
+    auto left = write_tree(entries.take_front(mid), print);
+    print.output() << fmt::line;
+    print.output().splice(entries[mid]->name);
+    print.output() << fmt::nbsp;
+    print.output().splice(entries[mid]->value);
+    print.output() << fmt::line;
+    auto right = write_tree(entries.drop_front(mid + 1), print);
+    auto height = std::max(left, right) + 1;
+    print.output() << fmt::nbsp << height << "%Z";
+    print.end_ctor();
+    return height;
+}
+
+void
+SortedModule::write(CoqPrinter& print) const {
+    const char* fields[] = {"symbols", "globals"};
+    print.begin_record(false);
+    for (unsigned t = 0; t < 2; ++t) {
+        // std::string compares bytes as unsigned characters, like `bs_cmp`.
+        // the sort is stable, so the last entry for a key is the one that
+        // `parser.v` would keep.
+        std::vector<const Entry*> entries;
+        for (auto& e : tables_[t]) {
+            entries.push_back(&e);
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry* a, const Entry* b) {
+                             return a->key < b->key;
+                         });
+        std::vector<const Entry*> unique;
+        for (auto e : entries) {
+            if (!unique.empty() && unique.back()->key == e->key) {
+                unique.back() = e;
+            } else {
+                unique.push_back(e);
+            }
+        }
+
+        if (t != 0) {
+            print.output() << fmt::line << "; ";
+        }
+        print.record_field(fields[t])
+            << "avl.of_sorted" << fmt::nbsp << fmt::indent;
+        write_tree(llvm::makeArrayRef(unique), print);
+        print.output() << fmt::outdent;
+    }
+    print.end_record();
+}
@@ -363,67 +363,80 @@ print_path(CoqPrinter &print, const DeclContext *dc, bool end = true) {
 }
 
 void
-write_globals(::Module &mod, CoqPrinter &print, ClangPrinter &cprint) {
+begin_globals(CoqPrinter &print) {
     print.output() << "Module _'." << fmt::indent << fmt::line;
+}
 
-    // todo(gmm): i would like to generate function names.
-    for (auto i : mod.definitions()) {
-        auto def = i.second;
-        if (const FieldDecl *fd = dyn_cast<FieldDecl>(def)) {
+void
+write_global(const NamedDecl *def, CoqPrinter &print, ClangPrinter &cprint) {
+    if (const FieldDecl *fd = dyn_cast<FieldDecl>(def)) {
+        print.output() << "Notation \"'";
+        print_path(print, fd->getParent(), true);
+        print.output() << fd->getNameAsString() << "'\" :=" << fmt::nbsp;
+        cprint.printField(fd, print);
+        print.output() << " (in custom cppglobal at level 0)." << fmt::line;
+    } else if (const RecordDecl *rd = dyn_cast<RecordDecl>(def)) {
+        if (!rd->isAnonymousStructOrUnion() &&
+            rd->getNameAsString() != "") {
             print.output() << "Notation \"'";
-            print_path(print, fd->getParent(), true);
-            print.output() << fd->getNameAsString() << "'\" :=" << fmt::nbsp;
-            cprint.printField(fd, print);
-            print.output() << " (in custom cppglobal at level 0)." << fmt::line;
-        } else if (const RecordDecl *rd = dyn_cast<RecordDecl>(def)) {
-            if (!rd->isAnonymousStructOrUnion() &&
-                rd->getNameAsString() != "") {
-                print.output() << "Notation \"'";
-                print_path(print, rd, false);
-                print.output() << "'\" :=" << fmt::nbsp;
+            print_path(print, rd, false);
+            print.output() << "'\" :=" << fmt::nbsp;
 
-                cprint.printGlobalName(def, print);
-                print.output()
-                    << "%bs (in custom cppglobal at level 0)." << fmt::line;
-            }
+            cprint.printGlobalName(def, print);
+            print.output()
+                << "%bs (in custom cppglobal at level 0)." << fmt::line;
+        }
 
-            for (auto fd : rd->fields()) {
-                if (fd->getName() != "") {
-                    print.output() << "Notation \"'";
-                    print_path(print, rd, true);
-                    print.output()
-                        << fd->getNameAsString() << "'\" :=" << fmt::nbsp;
-                    cprint.printField(fd, print);
-                    print.output()
-                        << " (in custom cppglobal at level 0)." << fmt::line;
-                }
+        for (auto fd : rd->fields()) {
+            if (fd->getName() != "") {
+                print.output() << "Notation \"'";
+                print_path(print, rd, true);
+                print.output()
+                    << fd->getNameAsString() << "'\" :=" << fmt::nbsp;
+                cprint.printField(fd, print);
+                print.output()
+                    << " (in custom cppglobal at level 0)." << fmt::line;
             }
-        } else if (const FunctionDecl *fd = dyn_cast<FunctionDecl>(def)) {
-            // todo(gmm): skipping due to function overloading
-        } else if (const TypedefDecl *td = dyn_cast<TypedefDecl>(def)) {
-            print.output() << "Notation \"'";
-            print_path(print, td->getDeclContext(), true);
-            print.output() << td->getNameAsString() << "'\" :=" << fmt::nbsp;
-            cprint.printQualType(td->getUnderlyingType(), print);
-            print.output() << " (in custom cppglobal at level 0)." << fmt::line;
-        } else if (isa<VarDecl>(def) || isa<EnumDecl>(def) || isa<EnumConstantDecl>(def)) {
-        } else {
-            using namespace logging;
-            log(Level::VERBOSE) << "unknown declaration type "
-                                << def->getDeclKindName() << "\n";
         }
+    } else if (const FunctionDecl *fd = dyn_cast<FunctionDecl>(def)) {
+        // todo(gmm): skipping due to function overloading
+    } else if (const TypedefDecl *td = dyn_cast<TypedefDecl>(def)) {
+        print.output() << "Notation \"'";
+        print_path(print, td->getDeclContext(), true);
+        print.output() << td->getNameAsString() << "'\" :=" << fmt::nbsp;
+        cprint.printQualType(td->getUnderlyingType(), print);
+        print.output() << " (in custom cppglobal at level 0)." << fmt::line;
+    } else if (isa<VarDecl>(def) || isa<EnumDecl>(def) || isa<EnumConstantDecl>(def)) {
+    } else {
+        using namespace logging;
+        log(Level::VERBOSE) << "unknown declaration type "
+                            << def->getDeclKindName() << "\n";
     }
+}
 
+void
+end_globals(CoqPrinter &print) {
     print.output() << fmt::outdent << "End _'." << fmt::line;
     print.output() << "Import _'." << fmt::line << fmt::line;
 }
 
 void
-write_spec(::Module *mod, const SpecCollector &specs,
-           const clang::TranslationUnitDecl *tu, Filter &filter,
+write_globals(::Module &mod, CoqPrinter &print, ClangPrinter &cprint) {
+    begin_globals(print);
+
+    // todo(gmm): i would like to generate function names.
+    for (auto i : mod.definitions()) {
+        write_global(i, print, cprint);
+    }
+
+    end_globals(print);
+}
+
+void
+write_spec(const SpecCollector &specs, const clang::TranslationUnitDecl *tu,
+           Filter &filter, llvm::StringRef globals, ClangPrinter &cprint,
            fmt::Formatter &output) {
     auto &ctxt = tu->getASTContext();
-    ClangPrinter cprint(&tu->getASTContext());
     CoqPrinter print(output);
     PrintSpec printer(ctxt);
 
@@ -441,7 +454,7 @@ write_spec(::Module *mod, const SpecCollector &specs,
     // it would be nice to include a top-level comment.
 
     // generate all of the record fields
-    write_globals(*mod, print, cprint);
+    output.splice(globals);
 
     std::list<const NamedDecl *> public_names;
     std::list<const NamedDecl *> internal_names;
@@ -465,11 +478,10 @@ write_spec(::Module *mod, const SpecCollector &specs,
                 assert(di.hasValue());
 
                 const NamedDecl *decl = di.getValue();
-                auto comment = ctxt.getCommentForDecl(decl, nullptr);
-                if (!printer.has_specification(*comment)) {
+                auto comment = specs.full_comment(c);
+                if (!comment || !printer.has_specification(*comment)) {
                     continue;
                 }
-                assert(comment && "decl with comment does not have comment");
 
                 output << "(* BEGIN_SOURCE("
                        << comment->getBeginLoc().printToString(
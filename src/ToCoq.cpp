@@ -8,14 +8,24 @@
 #include "CoqPrinter.hpp"
 #include "Filter.hpp"
 #include "ModuleBuilder.hpp"
+#include "PathPolicy.hpp"
+#include "Reachability.hpp"
 #include "SpecCollector.hpp"
 #include "clang/AST/Decl.h"
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Type.h"
 #include "clang/Basic/Version.inc"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include <Formatter.hpp>
+#include <algorithm>
 #include <list>
+#include <map>
+#include <memory>
+#include <vector>
 
 using namespace clang;
 using namespace fmt;
@@ -58,10 +68,532 @@ translateModule(const TranslationUnitDecl* decl, CoqPrinter& print, ClangPrinter
 #include "clang/Frontend/FrontendActions.h"
 
 #include "SpecCollector.hpp"
+#include "FragmentCache.hpp"
+#include "HeaderLibrary.hpp"
+#include "Logging.hpp"
+#include "SharedDefs.hpp"
+#include "SortedModule.hpp"
 #include "ToCoq.hpp"
+#include "TranslationCache.hpp"
 
 using namespace clang;
 
+// print `decl`, reusing the text printed by an earlier translation unit if it
+// was declared in a header
+static void
+print_decl(const Decl *decl, CoqPrinter &print, ClangPrinter &cprint,
+           FragmentCache *fragments, llvm::StringRef context_key) {
+    // note: fragments that refer to shared definitions only make sense in
+    // the file that they were printed for
+    auto &sm = decl->getASTContext().getSourceManager();
+    if (fragments == nullptr || cprint.getShared() != nullptr ||
+        sm.isInMainFile(sm.getExpansionLoc(decl->getLocation()))) {
+        cprint.printDecl(decl, print);
+        return;
+    }
+    auto depth = print.output().get_depth();
+    auto unnamed = cprint.unnamedTypesBefore(decl);
+    auto key = unnamed ? FragmentCache::fingerprint(decl, context_key, depth,
+                                                    *unnamed)
+                       : std::string();
+    if (key.empty()) {
+        cprint.printDecl(decl, print);
+        return;
+    }
+    std::string text;
+    if (!fragments->lookup(key, text)) {
+        llvm::raw_string_ostream out(text);
+        fmt::Formatter fmt(out, depth);
+        CoqPrinter fprint(fmt);
+        cprint.printDecl(decl, fprint);
+        out.flush();
+        fragments->insert(key, text);
+    }
+    print.output().splice(text);
+}
+
+// print the imports of a file that defines a module
+static void
+write_prologue(CoqPrinter &print, llvm::ArrayRef<std::string> libraries) {
+    auto &fmt = print.output();
+    fmt << "Require Import bedrock.lang.cpp.parser." << fmt::line;
+    for (auto &l : libraries) {
+        fmt << "Require " << l << "." << fmt::line;
+    }
+    fmt << fmt::line << "Local Open Scope bs_scope." << fmt::line;
+        // << "Import ListNotations." << fmt::line;
+}
+
+// print the beginning of the translation unit `name`, merged with the
+// modules in `libraries`. the declarations follow as a list, or as the
+// tables of a `SortedModule` if `sorted` is set.
+static void
+begin_module(CoqPrinter &print, llvm::ArrayRef<std::string> libraries,
+             bool sorted = false, llvm::StringRef name = "module") {
+    auto &fmt = print.output();
+    fmt << fmt::line << "Definition " << name
+        << " : translation_unit := " << fmt::indent << fmt::line;
+    if (sorted && libraries.empty()) {
+        return;
+    }
+    fmt << "Eval reduce_translation_unit in";
+    if (!libraries.empty()) {
+        fmt << fmt::nbsp << "translation_units" << fmt::nbsp;
+        print.begin_list();
+        for (auto &l : libraries) {
+            fmt << l << ".module";
+            print.cons();
+        }
+        fmt << fmt::line;
+    } else {
+        fmt << fmt::nbsp;
+    }
+    if (!sorted) {
+        fmt << "decls" << fmt::nbsp;
+        print.begin_list();
+    }
+}
+
+static void
+end_module(CoqPrinter &print, llvm::ArrayRef<std::string> libraries,
+           bool sorted = false) {
+    if (!sorted) {
+        print.end_list();
+    }
+    if (!libraries.empty()) {
+        print.cons();
+        print.end_list();
+    }
+    print.output() << "." << fmt::outdent << fmt::line;
+}
+
+// print the translation unit `module` that merges the translation units
+// `modules`, later modules take precedence. the merge is reduced.
+static void
+merge_modules(CoqPrinter &print, llvm::ArrayRef<std::string> modules) {
+    auto &fmt = print.output();
+    fmt << fmt::line << "Definition module : translation_unit := "
+        << fmt::indent << fmt::line;
+    fmt << "Eval reduce_translation_unit in" << fmt::nbsp;
+    fmt << "translation_units" << fmt::nbsp;
+    print.begin_list();
+    for (auto &m : modules) {
+        fmt << m;
+        print.cons();
+    }
+    print.end_list();
+    fmt << "." << fmt::outdent << fmt::line;
+}
+
+// print the definition of the translation unit `module` in the file `name`
+static void
+print_module(CoqPrinter &print, llvm::StringRef name,
+             llvm::ArrayRef<const Decl *> decls,
+             llvm::ArrayRef<std::string> libraries, ClangPrinter &cprint,
+             FragmentCache *fragments, llvm::StringRef context_key,
+             const ModuleFormat &format) {
+    if (!format.sorted && format.chunk != 0 && decls.size() > format.chunk) {
+        // each chunk is reduced by its own definition, which bounds the size
+        // of each reduction. the chunks are merged in order, so later
+        // declarations still take precedence. the merge is reduced, which
+        // only merges the tables of the chunks since they are already
+        // reduced, so the users of `module` do not pay for it. the chunks
+        // are named after the file so that files can be imported together.
+        std::vector<std::string> modules;
+        for (auto &l : libraries) {
+            modules.push_back(l + ".module");
+        }
+        unsigned chunks = 0;
+        for (size_t start = 0; start < decls.size();
+             start += format.chunk) {
+            auto chunk = (name + "_chunk" + std::to_string(++chunks)).str();
+            auto size =
+                std::min<size_t>(format.chunk, decls.size() - start);
+            begin_module(print, {}, false, chunk);
+            for (auto decl : decls.slice(start, size)) {
+                print_decl(decl, print, cprint, fragments, context_key);
+                print.cons();
+            }
+            end_module(print, {});
+            modules.push_back(chunk);
+        }
+        merge_modules(print, modules);
+        return;
+    }
+
+    if (!format.sorted) {
+        begin_module(print, libraries);
+        for (auto decl : decls) {
+            print_decl(decl, print, cprint, fragments, context_key);
+            print.cons();
+        }
+        end_module(print, libraries);
+        return;
+    }
+
+    // the declarations only add their entries to the tables, which are
+    // printed once they are complete
+    SortedModule module;
+    cprint.setSorted(&module);
+    for (auto decl : decls) {
+        cprint.printDecl(decl, print);
+    }
+    cprint.setSorted(nullptr);
+    begin_module(print, libraries, true);
+    module.write(print);
+    end_module(print, libraries, true);
+}
+
+// print `decls` as the translation unit `module` of the file `name`, merged
+// with the modules in `libraries`
+static void
+write_module(llvm::raw_ostream &out, llvm::StringRef name,
+             llvm::ArrayRef<const Decl *> decls,
+             llvm::ArrayRef<std::string> libraries, ClangPrinter &cprint,
+             FragmentCache *fragments, llvm::StringRef context_key,
+             const Sharing &sharing, const ModuleFormat &format) {
+    Formatter fmt(out);
+    CoqPrinter print(fmt);
+
+    write_prologue(print, libraries);
+    if (!sharing.enabled()) {
+        print_module(print, name, decls, libraries, cprint, fragments,
+                     context_key, format);
+        return;
+    }
+
+    // the shared definitions are only known once the module is printed, so
+    // the module is held back until they are written
+    SharedDefs defs(sharing);
+    std::string body;
+    llvm::raw_string_ostream body_output(body);
+    Formatter body_fmt(body_output);
+    CoqPrinter body_print(body_fmt);
+
+    cprint.setShared(&defs);
+    print_module(body_print, name, decls, libraries, cprint, fragments,
+                 context_key, format);
+    cprint.setShared(nullptr);
+    body_output.flush();
+
+    defs.write(fmt);
+    fmt.splice(body);
+}
+
+// prints the declarations of the module as soon as they are found, rather
+// than collecting them in a `::Module`. up to `window` declarations are held
+// back so that the declarations without definitions among them are printed
+// first, as they are in a module. the notations for the definitions are
+// printed to `globals` in the same pass.
+class StreamModule : public DeclSink {
+public:
+    StreamModule(CoqPrinter &print, ClangPrinter &cprint, unsigned window,
+                 CoqPrinter *globals, FragmentCache *fragments,
+                 llvm::StringRef context_key)
+        : print_(print), cprint_(cprint), window_(window), globals_(globals),
+          fragments_(fragments), context_key_(context_key) {}
+
+    void add_definition(const NamedDecl *d, bool opaque) override {
+        push(d, opaque);
+    }
+
+    void add_declaration(const NamedDecl *d) override {
+        push(d, true);
+    }
+
+    void flush() {
+        std::stable_partition(
+            pending_.begin(), pending_.end(),
+            [](const std::pair<const NamedDecl *, bool> &p) {
+                return p.second;
+            });
+        for (auto &p : pending_) {
+            print_decl(p.first, print_, cprint_, fragments_, context_key_);
+            print_.cons();
+            if (globals_ && !p.second) {
+                write_global(p.first, *globals_, cprint_);
+            }
+        }
+        pending_.clear();
+        ++flushes_;
+    }
+
+private:
+    // what is printed for the same entity later replaces what is printed
+    // earlier, so a definition must rank above any declaration of it
+    static int rank(const NamedDecl *d, bool declaration) {
+        return declaration ? defines(d) : 3 + defines(d);
+    }
+
+    void push(const NamedDecl *d, bool declaration) {
+        // the same entity can be found more than once, e.g. through each
+        // redeclaration of a template or an `extern` declaration after its
+        // definition. like `Module`, keep the redeclaration that defines the
+        // most: a pending one is replaced in place, a printed one is
+        // overridden by printing the new one after it.
+        auto r = rank(d, declaration);
+        auto found = seen_.insert(std::make_pair(
+            d->getCanonicalDecl(), Seen{r, pending_.size(), flushes_}));
+        if (!found.second) {
+            auto &seen = found.first->second;
+            if (r <= seen.rank) {
+                return;
+            }
+            seen.rank = r;
+            if (seen.flushes == flushes_) {
+                pending_[seen.index] = std::make_pair(d, declaration);
+                return;
+            }
+            seen.index = pending_.size();
+            seen.flushes = flushes_;
+        }
+        pending_.emplace_back(d, declaration);
+        if (pending_.size() > window_) {
+            flush();
+        }
+    }
+
+private:
+    struct Seen {
+        int rank;
+        // the position in `pending_`, if nothing was flushed since
+        size_t index;
+        unsigned flushes;
+    };
+
+    CoqPrinter &print_;
+    ClangPrinter &cprint_;
+    const unsigned window_;
+    CoqPrinter *const globals_;
+    FragmentCache *const fragments_;
+    const llvm::StringRef context_key_;
+    // keyed by the canonical declarations
+    llvm::DenseMap<const Decl *, Seen> seen_;
+    unsigned flushes_{0};
+    std::vector<std::pair<const NamedDecl *, bool>> pending_;
+};
+
+// move the definitions of headers into the libraries of the headers, the
+// names of the libraries are added to `modules`. the libraries that this
+// process has not written yet are written. the libraries are named after the
+// options of the translation (`variant`) and the printed definitions, since
+// the definitions of a header can depend on the macros that are defined
+// before it is included. returns the definitions that belong to the
+// translation unit itself.
+static std::vector<const Decl *>
+write_libraries(llvm::ArrayRef<const Decl *> definitions,
+                HeaderLibraries &libraries, std::vector<std::string> &modules,
+                ClangPrinter &cprint, FragmentCache *fragments,
+                llvm::StringRef context_key, llvm::StringRef variant,
+                const Sharing &sharing, const ModuleFormat &format) {
+    std::vector<const Decl *> own;
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<const Decl *>> headers;
+    for (auto decl : definitions) {
+        // note: implicit members and instantiations are only declared by the
+        // translation units that use them
+        auto &sm = decl->getASTContext().getSourceManager();
+        auto loc = sm.getExpansionLoc(decl->getLocation());
+        if (loc.isInvalid() || sm.isInMainFile(loc) || decl->isImplicit() ||
+            is_instantiated(decl) || sm.getFilename(loc).empty()) {
+            own.push_back(decl);
+            continue;
+        }
+        auto &group = headers[sm.getFilename(loc).str()];
+        if (group.empty()) {
+            order.push_back(sm.getFilename(loc).str());
+        }
+        group.push_back(decl);
+    }
+
+    for (auto &h : order) {
+        // note: the definitions are named after the header, so that the text
+        // does not depend on its own hash
+        auto prefix = libraries.prefix(h, variant);
+        std::string text;
+        {
+            llvm::raw_string_ostream out(text);
+            write_module(out, prefix, headers[h], {}, cprint, fragments,
+                         context_key, sharing, format);
+        }
+        auto module = libraries.module_name(prefix, text);
+        modules.push_back(module);
+        if (!libraries.claim(module)) {
+            continue;
+        }
+        // other processes may be writing the same library
+        auto path = libraries.path(module);
+        int fd;
+        llvm::SmallString<256> tmp;
+        if (auto ec = llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%",
+                                                      fd, tmp)) {
+            llvm::errs() << "Failed to open library file: " << path << "\n"
+                         << ec.message() << "\n";
+            continue;
+        }
+        {
+            llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+            out << text;
+        }
+        if (llvm::sys::fs::rename(tmp, path)) {
+            llvm::sys::fs::remove(tmp);
+        }
+    }
+    return own;
+}
+
+// the keys that `decls` add to the tables of the module, sorted. the names
+// are given the ids 1, 2, ... in this order.
+static std::vector<std::string>
+entry_names(llvm::ArrayRef<const Decl *> decls, ClangPrinter &cprint) {
+    std::vector<std::string> names;
+    for (auto decl : decls) {
+        // note: typedefs and enumerators are keyed by their plain names
+        if (auto td = dyn_cast<TypedefNameDecl>(decl)) {
+            names.push_back(td->getNameAsString());
+        } else if (auto ed = dyn_cast<EnumDecl>(decl)) {
+            names.push_back(cprint.mangledName(ed).str());
+            for (auto i : ed->enumerators()) {
+                names.push_back(i->getNameAsString());
+            }
+        } else if (isa<FunctionDecl>(decl) || isa<TagDecl>(decl) ||
+                   isa<EnumConstantDecl>(decl) ||
+                   (isa<VarDecl>(decl) && !decl->isTemplated())) {
+            names.push_back(cprint.mangledName(cast<NamedDecl>(decl)).str());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+// print the ids of `names` and the tables of `module` keyed by them
+static void
+write_ids(CoqPrinter &print, llvm::ArrayRef<std::string> names) {
+    auto &fmt = print.output();
+    fmt << fmt::line << "Definition name_ids : list (bs * positive) :="
+        << fmt::indent << fmt::line;
+    print.begin_list();
+    unsigned id = 0;
+    for (auto &n : names) {
+        fmt << fmt::line << "(";
+        print.str(n);
+        fmt << "," << fmt::nbsp << ++id << "%positive)";
+        print.cons();
+    }
+    print.end_list();
+    fmt << "." << fmt::outdent << fmt::line;
+
+    const char *tables[][2] = {{"symbols", "ObjValue"},
+                               {"globals", "GlobDecl"}};
+    for (auto &t : tables) {
+        fmt << fmt::line << "Definition " << t[0] << "_by_id : Pmap " << t[1]
+            << " :=" << fmt::indent << fmt::line
+            << "Eval reduce_translation_unit in by_id name_ids module.("
+            << t[0] << ")." << fmt::outdent << fmt::line;
+    }
+}
+
+// the size of `decl` in the source, used to balance the parts of a split
+// module without printing the declarations twice
+static unsigned
+source_size(const Decl *decl) {
+    auto &sm = decl->getASTContext().getSourceManager();
+    auto begin = sm.getDecomposedExpansionLoc(decl->getBeginLoc());
+    auto end = sm.getDecomposedExpansionLoc(decl->getEndLoc());
+    if (begin.first != end.first || end.second < begin.second) {
+        return 1;
+    }
+    return end.second - begin.second + 1;
+}
+
+// print `decls` into `parts` files that can be compiled independently, the
+// file `output` combines them into the translation unit `module` (with the
+// ids of `names` if they are requested). the declarations are split into
+// consecutive runs so that later declarations still take precedence when the
+// parts are merged.
+static void
+write_split(const std::string &output, llvm::ArrayRef<const Decl *> decls,
+            llvm::ArrayRef<std::string> libraries, unsigned parts,
+            ClangPrinter &cprint, FragmentCache *fragments,
+            llvm::StringRef context_key, const Sharing &sharing,
+            const ModuleFormat &format, llvm::ArrayRef<std::string> names) {
+    auto base = llvm::StringRef(output);
+    base.consume_back(".v");
+    auto name = llvm::sys::path::filename(base);
+
+    unsigned total = 0;
+    for (auto decl : decls) {
+        total += source_size(decl);
+    }
+
+    std::vector<std::string> files;
+    std::vector<std::string> modules(libraries.begin(), libraries.end());
+    size_t start = 0;
+    unsigned done = 0;
+    for (unsigned part = 1; start < decls.size() && part <= parts; ++part) {
+        // the parts fill up to an even share of the remaining size
+        auto budget = (total - done) / (parts - part + 1);
+        size_t end = start;
+        unsigned size = 0;
+        do {
+            size += source_size(decls[end]);
+            ++end;
+        } while (end < decls.size() && (part == parts || size < budget));
+        done += size;
+
+        auto module = (name + "_part" + std::to_string(part)).str();
+        auto file = (base + "_part" + std::to_string(part) + ".v").str();
+        std::error_code ec;
+        llvm::raw_fd_ostream part_output(file, ec);
+        if (ec.value()) {
+            llvm::errs() << "Failed to open generation file: " << file << "\n"
+                         << ec.message() << "\n";
+            return;
+        }
+        write_module(part_output, module, decls.slice(start, end - start), {},
+                     cprint, fragments, context_key, sharing, format);
+        files.push_back(file);
+        modules.push_back(module);
+        start = end;
+    }
+
+    std::error_code ec;
+    llvm::raw_fd_ostream code_output(output, ec);
+    if (ec.value()) {
+        llvm::errs() << "Failed to open generation file: " << output << "\n"
+                     << ec.message() << "\n";
+        return;
+    }
+    Formatter fmt(code_output);
+    CoqPrinter print(fmt);
+    fmt << "Require Import bedrock.lang.cpp.parser." << fmt::line;
+    for (auto &m : modules) {
+        fmt << "Require " << m << "." << fmt::line;
+    }
+    std::vector<std::string> parts;
+    for (auto &m : modules) {
+        parts.push_back(m + ".module");
+    }
+    merge_modules(print, parts);
+    if (format.ids) {
+        write_ids(print, names);
+    }
+
+    // the parts come first so that the project can be built in order
+    auto project = (base + "_CoqProject").str();
+    llvm::raw_fd_ostream project_output(project, ec);
+    if (ec.value()) {
+        llvm::errs() << "Failed to open project file: " << project << "\n"
+                     << ec.message() << "\n";
+        return;
+    }
+    for (auto &f : files) {
+        project_output << f << "\n";
+    }
+    project_output << output << "\n";
+}
+
 void
 ToCoqConsumer::toCoqModule(clang::ASTContext *ctxt,
                            const clang::TranslationUnitDecl *decl) {
@@ -73,61 +605,162 @@ ToCoqConsumer::toCoqModule(clang::ASTContext *ctxt,
 	filters.push_back(&fromComment);
 	Combine<Filter::What::NOTHING, Filter::max> filter(filters);
 #endif
+    const ModuleFormat &format = options_.format;
+    FragmentCache *fragments = options_.fragments;
+
+    // note: the translation unit is looked up in the cache before it is
+    // parsed (by the driver), its outputs are only added here. the cache only
+    // knows about the outputs that it is given.
+    const TranslationCache *cache = options_.cache;
+    llvm::StringRef key;
+    if (cache && options_.split <= 1 && options_.libraries == nullptr) {
+        key = options_.cache_key;
+    }
+
+    // note: the comments are only collected when they are printed
     SpecCollector specs;
-    Default filter(Filter::What::DEFINITION);
+    SpecCollector *collect = spec_file_.hasValue() ? &specs : nullptr;
+    Default all(Filter::What::DEFINITION);
+    std::unique_ptr<PathPolicy> policy;
+    if (format.paths) {
+        policy = std::make_unique<PathPolicy>(*format.paths,
+                                              ctxt->getSourceManager());
+    }
+    Filter &filter = policy ? static_cast<Filter &>(*policy) : all;
 
-    ::Module mod;
+    // all of the outputs share one printer (and mangler), and the notations
+    // for the names are printed once for both -names and -spec
+    ClangPrinter cprint(ctxt);
+    cprint.numberUnnamedTypes();
+    cprint.setFold(format.fold);
+    std::string context_key;
+    if (fragments) {
+        context_key = FragmentCache::context_key(*ctxt);
+    }
+    bool need_globals = notations_file_.hasValue() || spec_file_.hasValue();
+    std::string globals;
+    llvm::raw_string_ostream globals_output(globals);
+    Formatter globals_fmt(globals_output);
+    CoqPrinter globals_print(globals_fmt);
 
-    build_module(decl, mod, filter, specs);
+    // only the outputs that are written are added to the cache
+    bool module_written = true, notations_written = true, spec_written = true;
 
-    if (output_file_.hasValue()) {
+    // note: split modules and header libraries need all of the declarations
+    // before they can be printed, and streamed modules do not use shared
+    // definitions
+    bool streamed = false;
+    if (options_.stream && output_file_.hasValue() && options_.split <= 1 &&
+        options_.libraries == nullptr) {
         std::error_code ec;
         llvm::raw_fd_ostream code_output(*output_file_, ec);
         if (ec.value()) {
-            llvm::errs() << "Failed to open generation file: " << *output_file_
-                         << "\n"
+            llvm::errs() << "Failed to open generation file: "
+                         << *output_file_ << "\n"
                          << ec.message() << "\n";
         } else {
             Formatter fmt(code_output);
             CoqPrinter print(fmt);
-            ClangPrinter cprint(ctxt);
+            StreamModule stream(print, cprint, options_.stream_window,
+                                need_globals ? &globals_print : nullptr,
+                                fragments, context_key);
 
-            fmt << "Require Import bedrock.lang.cpp.parser." << fmt::line << fmt::line
-                << "Local Open Scope bs_scope." << fmt::line;
-                // << "Import ListNotations." << fmt::line;
+            write_prologue(print, {});
+            begin_module(print, {});
+            if (need_globals) {
+                begin_globals(globals_print);
+            }
+            if (format.prune) {
+                PruningSink pruned(format.roots);
+                build_module(decl, pruned, filter, collect);
+                pruned.flush(stream);
+            } else {
+                build_module(decl, stream, filter, collect);
+            }
+            stream.flush();
+            end_module(print, {});
+            if (need_globals) {
+                end_globals(globals_print);
+            }
+            streamed = true;
+        }
+    }
 
-            fmt << fmt::line
-                << "Definition module : translation_unit := " << fmt::indent
-                << fmt::line << "Eval reduce_translation_unit in decls"
-                << fmt::nbsp;
+    if (!streamed) {
+        ::Module mod;
+        if (format.prune) {
+            PruningSink pruned(format.roots);
+            build_module(decl, pruned, filter, collect);
+            pruned.flush(mod);
+        } else {
+            build_module(decl, mod, filter, collect);
+        }
 
-            print.begin_list();
-            for (auto entry : mod.imports()) {
-                auto decl = entry.second.first;
-                cprint.printDecl(decl, print);
-                print.cons();
+        if (output_file_.hasValue()) {
+            std::vector<const Decl *> decls(mod.imports().begin(),
+                                            mod.imports().end());
+            std::vector<const Decl *> definitions(mod.definitions().begin(),
+                                                  mod.definitions().end());
+            std::vector<std::string> names;
+            if (format.ids) {
+                std::vector<const Decl *> all(decls);
+                all.insert(all.end(), definitions.begin(), definitions.end());
+                names = entry_names(all, cprint);
             }
-            for (auto entry : mod.definitions()) {
-                auto decl = entry.second;
-                cprint.printDecl(decl, print);
-                print.cons();
+            std::vector<std::string> libraries;
+            if (options_.libraries) {
+                definitions = write_libraries(
+                    definitions, *options_.libraries, libraries, cprint,
+                    fragments, context_key, options_.flags, options_.sharing,
+                    format);
+            }
+            decls.insert(decls.end(), definitions.begin(), definitions.end());
+
+            if (options_.split > 1 && decls.size() > 1) {
+                write_split(*output_file_, decls, libraries, options_.split,
+                            cprint, fragments, context_key, options_.sharing,
+                            format, names);
+            } else {
+                std::error_code ec;
+                llvm::raw_fd_ostream code_output(*output_file_, ec);
+                if (ec.value()) {
+                    module_written = false;
+                    llvm::errs() << "Failed to open generation file: "
+                                 << *output_file_ << "\n"
+                                 << ec.message() << "\n";
+                } else {
+                    write_module(code_output,
+                                 llvm::sys::path::stem(*output_file_), decls,
+                                 libraries, cprint, fragments, context_key,
+                                 options_.sharing, format);
+                    if (format.ids) {
+                        Formatter fmt(code_output);
+                        CoqPrinter print(fmt);
+                        write_ids(print, names);
+                    }
+                }
             }
-            print.end_list();
-            print.output() << "." << fmt::outdent << fmt::line;
+        }
+
+        // note: this comes after the module so that the module's names do
+        // not depend on the other outputs
+        if (need_globals) {
+            write_globals(mod, globals_print, cprint);
         }
     }
+    globals_output.flush();
 
     if (notations_file_.hasValue()) {
         std::error_code ec;
         llvm::raw_fd_ostream notations_output(*notations_file_, ec);
         if (ec.value()) {
+            notations_written = false;
             llvm::errs() << "Failed to open notations file: "
                          << *notations_file_ << "\n"
                          << ec.message() << "\n";
         } else {
             fmt::Formatter spec_fmt(notations_output);
             auto &ctxt = decl->getASTContext();
-            ClangPrinter cprint(&decl->getASTContext());
             CoqPrinter print(spec_fmt);
             // PrintSpec printer(ctxt);
 
@@ -144,7 +777,7 @@ ToCoqConsumer::toCoqModule(clang::ASTContext *ctxt,
                            << fmt::line;
 
             // generate all of the record fields
-            write_globals(mod, print, cprint);
+            spec_fmt.splice(globals);
         }
     }
 
@@ -152,12 +785,22 @@ ToCoqConsumer::toCoqModule(clang::ASTContext *ctxt,
         std::error_code ec;
         llvm::raw_fd_ostream spec_output(*spec_file_, ec);
         if (ec.value()) {
+            spec_written = false;
             llvm::errs() << "Failed to open specification file: " << *spec_file_
                          << "\n"
                          << ec.message() << "\n";
         } else {
             fmt::Formatter spec_fmt(spec_output);
-            write_spec(&mod, specs, decl, filter, spec_fmt);
+            write_spec(specs, decl, filter, globals, cprint, spec_fmt);
         }
     }
+
+    if (!key.empty()) {
+        auto written = [](bool ok, const Optional<std::string> &file) {
+            return ok ? file : Optional<std::string>();
+        };
+        cache->store(key, written(module_written, output_file_),
+                     written(notations_written, notations_file_),
+                     written(spec_written, spec_file_));
+    }
 }
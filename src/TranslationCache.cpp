@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "TranslationCache.hpp"
+#include "Logging.hpp"
+#include "Version.hpp"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/SourceManager.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <vector>
+
+using namespace clang;
+
+static std::string
+to_hex(llvm::MD5& hash) {
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+    llvm::SmallString<32> str;
+    llvm::MD5::stringifyResult(result, str);
+    return str.str().str();
+}
+
+std::string
+TranslationCache::key(const SourceManager& sm, llvm::StringRef flags) const {
+    // note: files are hashed as the translation unit read them, including
+    // buffers that were remapped or loaded from a preamble, together with
+    // the path they were found at (the outputs name the main file). the
+    // order of the hashes is made canonical by sorting them.
+    std::vector<std::string> files;
+    for (auto i = sm.fileinfo_begin(), e = sm.fileinfo_end(); i != e; ++i) {
+        auto fid = sm.translateFile(i->first);
+        bool invalid = false;
+        auto data = fid.isValid() ? sm.getBufferData(fid, &invalid)
+                                  : llvm::StringRef();
+        if (fid.isInvalid() || invalid) {
+            // there is no way to tell if an entry is current
+            return "";
+        }
+        llvm::MD5 hash;
+        hash.update(i->first->getName());
+        hash.update(llvm::StringRef("\0", 1));
+        hash.update(data);
+        files.push_back(to_hex(hash));
+    }
+    std::sort(files.begin(), files.end());
+
+    llvm::MD5 hash;
+    hash.update(cpp2v::VERSION);
+    hash.update(llvm::StringRef("\0", 1));
+    hash.update(flags);
+    hash.update(llvm::StringRef("\0", 1));
+    // the main file determines the contents of the output even when the same
+    // files are read, e.g. a header that is compiled on its own
+    if (auto main = sm.getFileEntryForID(sm.getMainFileID())) {
+        hash.update(main->getName());
+    }
+    for (auto& f : files) {
+        hash.update(llvm::StringRef("\0", 1));
+        hash.update(f);
+    }
+    return to_hex(hash);
+}
+
+std::string
+TranslationCache::entry(llvm::StringRef key, llvm::StringRef kind) const {
+    llvm::SmallString<256> path(dir_);
+    llvm::sys::path::append(path, key.take_front(2), key, kind);
+    return path.str().str();
+}
+
+bool
+TranslationCache::fetch(llvm::StringRef key,
+                        const llvm::Optional<std::string>& module,
+                        const llvm::Optional<std::string>& names,
+                        const llvm::Optional<std::string>& spec) const {
+    std::pair<const llvm::Optional<std::string>*, const char*> outputs[] = {
+        {&module, "module.v"}, {&names, "names.v"}, {&spec, "spec.v"}};
+    for (auto& o : outputs) {
+        if (o.first->hasValue() &&
+            !llvm::sys::fs::exists(entry(key, o.second))) {
+            return false;
+        }
+    }
+    for (auto& o : outputs) {
+        if (o.first->hasValue()) {
+            if (auto ec = llvm::sys::fs::copy_file(entry(key, o.second),
+                                                   **o.first)) {
+                logging::log() << "Failed to copy cached " << o.second
+                               << " to " << **o.first << ": " << ec.message()
+                               << "\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void
+TranslationCache::store(llvm::StringRef key,
+                        const llvm::Optional<std::string>& module,
+                        const llvm::Optional<std::string>& names,
+                        const llvm::Optional<std::string>& spec) const {
+    std::pair<const llvm::Optional<std::string>*, const char*> outputs[] = {
+        {&module, "module.v"}, {&names, "names.v"}, {&spec, "spec.v"}};
+    for (auto& o : outputs) {
+        if (!o.first->hasValue()) {
+            continue;
+        }
+        auto path = entry(key, o.second);
+        if (auto ec = llvm::sys::fs::create_directories(
+                llvm::sys::path::parent_path(path))) {
+            logging::log() << "Failed to create cache entry " << path << ": "
+                           << ec.message() << "\n";
+            return;
+        }
+        // other processes may be reading or writing the same entry, so
+        // the file is only moved into place once it is complete
+        int fd;
+        llvm::SmallString<256> tmp;
+        if (llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%", fd, tmp)) {
+            return;
+        }
+        auto buffer = llvm::MemoryBuffer::getFile(**o.first);
+        {
+            llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+            if (buffer) {
+                out << (*buffer)->getBuffer();
+            }
+        }
+        if (!buffer || llvm::sys::fs::rename(tmp, path)) {
+            llvm::sys::fs::remove(tmp);
+        }
+    }
+}
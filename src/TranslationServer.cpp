@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) BedRock Systems Inc. 2020 Gregory Malecha
+ *
+ * SPDX-License-Identifier:AGPL-3.0-or-later
+ */
+#include "clang/AST/ASTConsumer.h"
+#include "clang/Basic/Version.inc"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/PCHContainerOperations.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <errno.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#include "Logging.hpp"
+#include "ToCoq.hpp"
+#include "TranslationServer.hpp"
+
+using namespace clang;
+
+namespace {
+
+struct Request {
+    std::string source;
+    std::vector<std::string> args;
+    Optional<std::string> output;
+    Optional<std::string> names;
+    Optional<std::string> spec;
+
+    // identifies the compile command, units are only reused when the
+    // source and all arguments match
+    std::string key() const {
+        std::string result = source;
+        for (auto &a : args) {
+            result += '\0';
+            result += a;
+        }
+        return result;
+    }
+};
+
+class Server {
+public:
+    Server(const char* argv0, unsigned max_units, const ToCoqOptions& options)
+        : pch_(std::make_shared<PCHContainerOperations>()),
+          resources_(CompilerInvocation::GetResourcesPath(
+              argv0, (void*)(intptr_t)run_server)),
+          max_units_(max_units), options_(options) {}
+
+    // translate the request, on failure the reason is stored in `error`
+    bool translate(const Request& req, std::string& error) {
+        auto unit = get_unit(req, error);
+        if (unit == nullptr) {
+            return false;
+        }
+        if (unit->getDiagnostics().hasErrorOccurred()) {
+            error = "failed to parse " + req.source;
+            return false;
+        }
+        ToCoqConsumer consumer(req.output, req.spec, req.names, options_);
+        consumer.HandleTranslationUnit(unit->getASTContext());
+        return true;
+    }
+
+private:
+    ASTUnit* get_unit(const Request& req, std::string& error) {
+        auto key = req.key();
+        auto found = units_.find(key);
+        if (found != units_.end()) {
+            // most recently used units are at the front
+            lru_.remove(key);
+            lru_.push_front(key);
+            logging::log() << "reparsing " << req.source << "\n";
+            if (found->second->Reparse(pch_)) {
+                units_.erase(found);
+                lru_.pop_front();
+                error = "failed to reparse " + req.source;
+                return nullptr;
+            }
+            return found->second.get();
+        }
+
+        std::vector<const char*> argv;
+        argv.push_back("clang");
+        for (auto& a : req.args) {
+            argv.push_back(a.c_str());
+        }
+        argv.push_back(req.source.c_str());
+
+        logging::log() << "parsing " << req.source << "\n";
+        IntrusiveRefCntPtr<DiagnosticsEngine> diags =
+            CompilerInstance::createDiagnostics(new DiagnosticOptions());
+        std::unique_ptr<ASTUnit> unit = ASTUnit::LoadFromCommandLine(
+            argv.data(), argv.data() + argv.size(), pch_, diags, resources_,
+            /*OnlyLocalDecls=*/false,
+#if CLANG_VERSION_MAJOR >= 10
+            CaptureDiagsKind::None,
+#else
+            /*CaptureDiagnostics=*/false,
+#endif
+            /*RemappedFiles=*/None, /*RemappedFilesKeepOriginalName=*/true,
+            /*PrecompilePreambleAfterNParses=*/1);
+        if (!unit) {
+            error = "failed to parse " + req.source;
+            return nullptr;
+        }
+
+        if (units_.size() >= max_units_ && !lru_.empty()) {
+            units_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        lru_.push_front(key);
+        return (units_[key] = std::move(unit)).get();
+    }
+
+private:
+    std::shared_ptr<PCHContainerOperations> pch_;
+    const std::string resources_;
+    const unsigned max_units_;
+    const ToCoqOptions options_;
+    std::map<std::string, std::unique_ptr<ASTUnit>> units_;
+    std::list<std::string> lru_;
+};
+
+// read the request from the connection, on failure the reason is stored in
+// `error`
+bool
+read_request(int conn, Request& req, bool& shutdown, std::string& error) {
+    std::string buffer;
+    char chunk[4096];
+    for (;;) {
+        auto n = read(conn, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            error = "request timed out";
+            return false;
+        }
+        if (n <= 0) {
+            break;
+        }
+        buffer.append(chunk, n);
+        if (buffer == "shutdown\n" ||
+            buffer.find("\nend\n") != std::string::npos ||
+            StringRef(buffer).startswith("end\n")) {
+            break;
+        }
+    }
+
+    error = "malformed request";
+    StringRef rest(buffer);
+    while (!rest.empty()) {
+        auto both = rest.split('\n');
+        auto field = both.first.split(' ');
+        rest = both.second;
+        if (field.first == "shutdown") {
+            shutdown = true;
+            return true;
+        } else if (field.first == "end") {
+            return !req.source.empty();
+        } else if (field.first == "source") {
+            req.source = field.second.str();
+        } else if (field.first == "arg") {
+            req.args.push_back(field.second.str());
+        } else if (field.first == "o") {
+            req.output = field.second.str();
+        } else if (field.first == "names") {
+            req.names = field.second.str();
+        } else if (field.first == "spec") {
+            req.spec = field.second.str();
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+void
+respond(int conn, StringRef msg) {
+    auto data = msg.data();
+    auto left = msg.size();
+    while (left > 0) {
+        // note: a client that has gone away must not kill the server
+        auto n = send(conn, data, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        left -= n;
+    }
+}
+
+}
+
+int
+run_server(const std::string& socket_path, const char* argv0,
+           unsigned max_units, unsigned timeout, const ToCoqOptions& options) {
+    sockaddr_un addr;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        llvm::errs() << "Socket path is too long: " << socket_path << "\n";
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        llvm::errs() << "Failed to create socket: " << strerror(errno) << "\n";
+        return 1;
+    }
+    unlink(socket_path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 16) != 0) {
+        llvm::errs() << "Failed to listen on " << socket_path << ": "
+                     << strerror(errno) << "\n";
+        close(fd);
+        return 1;
+    }
+
+    Server server(argv0, max_units, options);
+    bool shutdown = false;
+    while (!shutdown) {
+        int conn = accept(fd, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            llvm::errs() << "Failed to accept connection: " << strerror(errno)
+                         << "\n";
+            break;
+        }
+
+        // a client that stalls only holds up the server until the timeout
+        if (timeout != 0) {
+            timeval limit;
+            limit.tv_sec = timeout;
+            limit.tv_usec = 0;
+            setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+            setsockopt(conn, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+        }
+
+        Request req;
+        std::string error;
+        if (!read_request(conn, req, shutdown, error)) {
+            respond(conn, "error " + error + "\n");
+        } else if (shutdown) {
+            respond(conn, "ok\n");
+        } else if (server.translate(req, error)) {
+            respond(conn, "ok\n");
+        } else {
+            respond(conn, "error " + error + "\n");
+        }
+        close(conn);
+    }
+
+    close(fd);
+    unlink(socket_path.c_str());
+    return 0;
+}
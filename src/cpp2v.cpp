@@ -9,17 +9,30 @@
 #include "clang/AST/ASTConsumer.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
+#include <algorithm>
+#include <atomic>
 #include <optional>
+#include <set>
+#include <thread>
 
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/Tooling.h"
 // Declares clang::SyntaxOnlyAction.
 #include "clang/Frontend/FrontendActions.h"
+#include "clang/Basic/Version.inc"
 // Declares llvm::cl::extrahelp.
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 
+#include "FragmentCache.hpp"
+#include "HeaderLibrary.hpp"
 #include "Logging.hpp"
+#include "PathPolicy.hpp"
 #include "ToCoq.hpp"
+#include "TranslationCache.hpp"
+#include "TranslationServer.hpp"
 #include "Version.hpp"
 
 using namespace clang;
@@ -47,6 +60,180 @@ static cl::opt<std::string> VFileOutput("o",
                                         cl::desc("path to generate the module"),
                                         cl::Optional, cl::cat(Cpp2V));
 
+static cl::opt<std::string> OutDir(
+    "out-dir",
+    cl::desc("directory to generate the outputs of each source file in"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<std::string>
+    OutPattern("out-pattern",
+               cl::desc("name of the module generated in -out-dir, `{stem}` "
+                        "is the name of the source file without extension"),
+               cl::init("{stem}_cpp.v"), cl::cat(Cpp2V));
+
+static cl::opt<std::string>
+    NamesPattern("names-pattern",
+                 cl::desc("name of the names generated in -out-dir"),
+                 cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<std::string>
+    SpecPattern("spec-pattern",
+                cl::desc("name of the specifications generated in -out-dir"),
+                cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<std::string>
+    ServerSocket("server",
+                 cl::desc("serve translation requests on this Unix socket"),
+                 cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> ServerUnits(
+    "server-units",
+    cl::desc("number of parsed translation units kept by the server"),
+    cl::init(32), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> ServerTimeout(
+    "server-timeout",
+    cl::desc("seconds that the server waits for a request on a connection "
+             "(0 waits forever)"),
+    cl::init(10), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<std::string>
+    CacheDir("cache-dir",
+             cl::desc("directory to cache generated files in, it can be "
+                      "shared between builds that use the same paths"),
+             cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> ShareDecls(
+    "share-header-decls",
+    cl::desc("print the declarations of headers once and reuse the text in "
+             "every translation unit that includes them"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned>
+    Split("split",
+          cl::desc("split the module into this many files that can be "
+                   "compiled in parallel"),
+          cl::init(0), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<std::string> HeaderLibDir(
+    "header-lib-dir",
+    cl::desc("directory to write the definitions of headers to, the modules "
+             "of translation units import them instead of repeating them"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool>
+    Stream("stream",
+           cl::desc("print the declarations of the module as they are found "
+                    "instead of collecting them first"),
+           cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> StreamWindow(
+    "stream-window",
+    cl::desc("number of declarations -stream holds back to print the "
+             "declarations without definitions first"),
+    cl::init(0), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> ShareNames(
+    "share-names",
+    cl::desc("define each mangled name once and refer to it by name in the "
+             "module"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> ShareTypes(
+    "share-types",
+    cl::desc("define each type once and refer to it by name in the module"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> ShareTerms(
+    "share-terms",
+    cl::desc("define each statement and expression that prints to at least "
+             "this many characters once and refer to it by name in the "
+             "module (0 disables it)"),
+    cl::init(0), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> OutlineBlocks(
+    "outline-blocks",
+    cl::desc("define each block (and part of a list of statements) of a "
+             "function body that prints to at least this many characters "
+             "separately and refer to it by name, which bounds the size of "
+             "the terms in the module (0 disables it)"),
+    cl::init(0), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> Sorted(
+    "sorted-module",
+    cl::desc("print the tables of the module as sorted trees, which are not "
+             "reduced when the module is compiled"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<unsigned> Chunk(
+    "chunk",
+    cl::desc("reduce the declarations of the module in chunks of this many, "
+             "each in its own definition that the module merges (0 reduces "
+             "them all at once)"),
+    cl::init(0), cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> SymbolIds(
+    "symbol-ids",
+    cl::desc("number the names of the module and print its tables keyed by "
+             "these ids"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> Prune(
+    "prune",
+    cl::desc("only translate the declarations that are reachable from the "
+             "main file"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::list<std::string> Roots(
+    "root",
+    cl::desc("only translate the declarations that are reachable from the "
+             "declaration with this qualified name (implies -prune)"),
+    cl::ZeroOrMore, cl::cat(Cpp2V));
+
+static cl::opt<bool> FoldConstants(
+    "fold-constants",
+    cl::desc("print the values of constexpr variables, enumerators, sizeof "
+             "and alignof rather than the expressions that compute them"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::list<std::string> IncludePaths(
+    "include-path",
+    cl::desc("translate the declarations of the files that match this glob, "
+             "overriding an earlier -exclude-path"),
+    cl::ZeroOrMore, cl::cat(Cpp2V));
+
+static cl::list<std::string> ExcludePaths(
+    "exclude-path",
+    cl::desc("do not translate the declarations of the files that match "
+             "this glob, e.g. '/usr/include/*'"),
+    cl::ZeroOrMore, cl::cat(Cpp2V));
+
+static cl::list<std::string> IncludeNamespaces(
+    "include-ns",
+    cl::desc("translate the declarations of this namespace (and the "
+             "namespaces nested in it), overriding an earlier -exclude-ns"),
+    cl::ZeroOrMore, cl::cat(Cpp2V));
+
+static cl::list<std::string> ExcludeNamespaces(
+    "exclude-ns",
+    cl::desc("do not translate the declarations of this namespace (and the "
+             "namespaces nested in it), e.g. 'std::__detail'"),
+    cl::ZeroOrMore, cl::cat(Cpp2V));
+
+static cl::opt<std::string> FilterFile(
+    "filter-file",
+    cl::desc("read path and namespace rules from this file, one per line "
+             "('+path <glob>', '-path <glob>', '+ns <name>' or '-ns <name>'), "
+             "before the rules given on the command line"),
+    cl::Optional, cl::cat(Cpp2V));
+
+static cl::opt<bool> SkipBodies(
+    "skip-function-bodies",
+    cl::desc("do not parse the bodies of functions when the module is not "
+             "generated, the templates that they instantiate are then missing "
+             "from -names and -spec"),
+    cl::Optional, cl::cat(Cpp2V));
+
 static cl::opt<bool> Verbose("v", cl::desc("verbose"), cl::Optional,
                              cl::cat(Cpp2V));
 static cl::opt<bool> Verboser("vv", cl::desc("verboser"), cl::Optional,
@@ -55,8 +242,170 @@ static cl::opt<bool> Verboser("vv", cl::desc("verboser"), cl::Optional,
 static cl::opt<bool> Version("cpp2v-version", cl::Optional, cl::ValueOptional,
                              cl::cat(Cpp2V));
 
+static cl::opt<unsigned>
+    Jobs("j", cl::desc("number of translation units to translate in parallel"),
+         cl::init(1), cl::Optional, cl::cat(Cpp2V));
+
+// The path of an output of `source` in -out-dir, e.g. with the pattern
+// `{stem}_cpp.v` the source `src/foo.cpp` is translated to `<dir>/foo_cpp.v`.
+static std::string
+out_path(const std::string &pattern, StringRef source) {
+    auto stem = llvm::sys::path::stem(source);
+    std::string name = pattern;
+    for (auto pos = name.find("{stem}"); pos != std::string::npos;
+         pos = name.find("{stem}", pos + stem.size())) {
+        name.replace(pos, 6, stem.str());
+    }
+    SmallString<256> path(OutDir);
+    llvm::sys::path::append(path, name);
+    return path.str().str();
+}
+
+// remove the outputs of `source` in -out-dir
+static void
+remove_outputs(StringRef source) {
+    if (OutDir.empty()) {
+        return;
+    }
+    for (auto pattern : {&OutPattern, &NamesPattern, &SpecPattern}) {
+        if (!pattern->empty()) {
+            llvm::sys::fs::remove(out_path(*pattern, source));
+        }
+    }
+}
+
+static std::unique_ptr<TranslationCache> Cache;
+
+// shared by all of the translation units (and workers) of this process
+static FragmentCache Fragments;
+static std::unique_ptr<HeaderLibraries> Libraries;
+static std::unique_ptr<PathRules> Paths;
+
+static Sharing
+sharing() {
+    Sharing result;
+    result.names = ShareNames;
+    result.types = ShareTypes;
+    result.terms = ShareTerms;
+    result.blocks = OutlineBlocks;
+    return result;
+}
+
+static ModuleFormat
+module_format() {
+    ModuleFormat result;
+    result.sorted = Sorted;
+    result.chunk = Chunk;
+    result.ids = SymbolIds;
+    result.prune = Prune || !Roots.empty();
+    result.roots.assign(Roots.begin(), Roots.end());
+    result.paths = Paths.get();
+    result.fold = FoldConstants;
+    return result;
+}
+
+// the options of the translation units of this process, `flags` describes
+// the options of the translation unit
+static ToCoqOptions
+translation_options(const std::string &flags) {
+    ToCoqOptions result;
+    result.cache = Cache.get();
+    result.flags = flags;
+    result.fragments = ShareDecls ? &Fragments : nullptr;
+    result.split = Split;
+    result.libraries = Libraries.get();
+    result.stream = Stream;
+    result.stream_window = StreamWindow;
+    result.sharing = sharing();
+    result.format = module_format();
+    return result;
+}
+
+// the options of a translation unit that `Compiler` parses, as a string
+static std::string
+translation_flags(clang::CompilerInstance &Compiler) {
+    // the flags describe the options that change the output, they key the
+    // cache and name the header libraries. the module hash covers the
+    // options that change the parse, it does not depend on the include paths
+    // (the contents of the included files are part of the cache key)
+    std::string flags =
+        Compiler.getInvocation().getModuleHash() + "," +
+        std::to_string(Compiler.getLangOpts().CommentOpts.ParseAllComments);
+    // streaming changes the order of the declarations
+    if (Stream) {
+        flags += ",stream=" + std::to_string(StreamWindow);
+    }
+    flags += ",share=" + std::to_string(ShareNames) +
+             std::to_string(ShareTypes) + "," +
+             std::to_string(ShareTerms) + "," +
+             std::to_string(OutlineBlocks);
+    flags += ",skip=" +
+             std::to_string(Compiler.getFrontendOpts().SkipFunctionBodies) +
+             ",split=" + std::to_string(Split) + ",lib=" + HeaderLibDir +
+             ",decls=" + std::to_string(ShareDecls);
+    flags += ",sorted=" + std::to_string(Sorted) +
+             ",chunk=" + std::to_string(Chunk) +
+             ",ids=" + std::to_string(SymbolIds) +
+             ",fold=" + std::to_string(FoldConstants);
+    if (Paths) {
+        flags += ",paths=" + Paths->text();
+    }
+    if (Prune || !Roots.empty()) {
+        flags += ",prune";
+        for (auto &r : Roots) {
+            flags += ";" + r;
+        }
+    }
+    return flags;
+}
+
+// the key of the translation unit of `Compiler` in the cache. the translation
+// unit is preprocessed on its own, which finds the files that it reads
+// without parsing it. returns the empty string if it can not be cached.
+static std::string
+cache_key(clang::CompilerInstance &Compiler) {
+    clang::CompilerInstance pp(Compiler.getPCHContainerOperations());
+    pp.setInvocation(
+        std::make_shared<clang::CompilerInvocation>(Compiler.getInvocation()));
+    // note: the diagnostics are reported when the translation unit is parsed
+    pp.createDiagnostics(new clang::IgnoringDiagConsumer(),
+                         /*ShouldOwnClient=*/true);
+    pp.setFileManager(&Compiler.getFileManager());
+    clang::PreprocessOnlyAction action;
+    if (!pp.ExecuteAction(action) || pp.getDiagnostics().hasErrorOccurred()) {
+        return "";
+    }
+    return Cache->key(pp.getSourceManager(), translation_flags(Compiler));
+}
+
 class ToCoqAction : public clang::ASTFrontendAction {
 public:
+    virtual bool BeginSourceFileAction(clang::CompilerInstance &Compiler) {
+        // the notations and specifications only need the declarations, but
+        // the bodies of functions instantiate templates, so they are only
+        // skipped on request
+        if (SkipBodies && VFileOutput.empty() && OutDir.empty()) {
+            Compiler.getFrontendOpts().SkipFunctionBodies = true;
+        }
+
+        // a translation unit that is found in the cache is not parsed. split
+        // modules and header libraries are not cached.
+        cache_key_.clear();
+        cached_ = false;
+        if (Cache && Split <= 1 && HeaderLibDir.empty()) {
+            auto file = getCurrentFile();
+            cache_key_ = cache_key(Compiler);
+            if (!cache_key_.empty() &&
+                Cache->fetch(cache_key_, module_file(file), names_file(file),
+                             spec_file(file))) {
+                logging::log() << "Using cached translation " << cache_key_
+                               << "\n";
+                cached_ = true;
+            }
+        }
+        return true;
+    }
+
     virtual std::unique_ptr<clang::ASTConsumer>
     CreateASTConsumer(clang::CompilerInstance &Compiler,
                       llvm::StringRef InFile) {
@@ -67,11 +416,48 @@ public:
 			llvm::errs() << i << "\n";
 		}
 #endif
-        auto result = new ToCoqConsumer(to_opt(VFileOutput), to_opt(SpecFile),
-                                        to_opt(NamesFile));
+        auto options = translation_options(translation_flags(Compiler));
+        options.cache_key = cache_key_;
+        auto result =
+            new ToCoqConsumer(module_file(InFile), spec_file(InFile),
+                              names_file(InFile), options);
         return std::unique_ptr<clang::ASTConsumer>(result);
     }
 
+    virtual void ExecuteAction() {
+        // the outputs were copied from the cache
+        if (!cached_) {
+            clang::ASTFrontendAction::ExecuteAction();
+        }
+    }
+
+    // the outputs of the main file `InFile`, with -out-dir they are derived
+    // from the name of the main file of the compilation database
+    Optional<std::string> module_file(StringRef InFile) {
+        return OutDir.empty() ? to_opt(VFileOutput)
+                              : Optional<std::string>(out_path(OutPattern,
+                                                               InFile));
+    }
+
+    Optional<std::string> names_file(StringRef InFile) {
+        return OutDir.empty() ? to_opt(NamesFile)
+                              : from_pattern(NamesPattern, InFile);
+    }
+
+    Optional<std::string> spec_file(StringRef InFile) {
+        return OutDir.empty() ? to_opt(SpecFile)
+                              : from_pattern(SpecPattern, InFile);
+    }
+
+    Optional<std::string> from_pattern(const cl::opt<std::string> &pattern,
+                                       StringRef source) {
+        if (pattern.empty()) {
+            return Optional<std::string>();
+        } else {
+            return Optional<std::string>(out_path(pattern, source));
+        }
+    }
+
     template<typename T>
     Optional<T> to_opt(const cl::opt<T> &val) {
         if (val.empty()) {
@@ -80,11 +466,69 @@ public:
             return Optional<T>(val.getValue());
         }
     }
+
+private:
+    std::string cache_key_;
+    bool cached_ = false;
 };
 
+// Translate `sources` on `jobs` worker threads.
+//
+// Every worker pulls the next source off a shared counter and runs it through
+// its own `ClangTool`, so the `FileManager`, the diagnostics and (through
+// `ToCoqConsumer`) the `ClangPrinter`/`MangleContext` are never shared between
+// threads. A translation unit that fails to parse is reported by the tool and
+// remembered in the exit code, but the remaining units are still translated.
+// A fatal error (`logging::die`) or a crash is recovered from in the same way,
+// and the outputs of that unit are removed since they may be partial.
+static int
+run_parallel(const CompilationDatabase &db,
+             const std::vector<std::string> &sources, unsigned jobs) {
+    std::atomic<size_t> next(0);
+    std::atomic<int> result(0);
+
+    llvm::CrashRecoveryContext::Enable();
+    auto worker = [&]() {
+        auto factory = newFrontendActionFactory<ToCoqAction>();
+        for (size_t i = next++; i < sources.size(); i = next++) {
+            // note: each tool gets a private view of the file system so that
+            // changing into the compilation directory of one translation unit
+            // does not change the working directory of the other workers.
+#if CLANG_VERSION_MAJOR >= 8
+            ClangTool Tool(db, sources[i],
+                           std::make_shared<PCHContainerOperations>(),
+                           llvm::vfs::createPhysicalFileSystem().release());
+#else
+            ClangTool Tool(db, sources[i]);
+#endif
+            int err = 0;
+            llvm::CrashRecoveryContext crc;
+            if (!crc.RunSafely([&]() { err = Tool.run(factory.get()); })) {
+                llvm::errs() << "Failed to translate " << sources[i] << "\n";
+                remove_outputs(sources[i]);
+                err = 1;
+            }
+            if (err) {
+                result = err;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < jobs && i < sources.size(); ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    return result;
+}
+
 int
 main(int argc, const char **argv) {
-    CommonOptionsParser OptionsParser(argc, argv, Cpp2V);
+    // note: source files are optional because the server receives them with
+    // each request.
+    CommonOptionsParser OptionsParser(argc, argv, Cpp2V, cl::ZeroOrMore);
 
     if (Version) {
         llvm::errs() << "cpp2v version " << cpp2v::VERSION << "\n";
@@ -99,6 +543,143 @@ main(int argc, const char **argv) {
         logging::set_level(logging::NONE);
     }
 
+    // note: the declarations of a streamed module are printed as they are
+    // found, before the shared definitions and tables would be known
+    if (Stream && (Sorted || Chunk || SymbolIds || ShareNames || ShareTypes ||
+                   ShareTerms || OutlineBlocks)) {
+        llvm::errs() << "-stream can not be combined with -sorted-module, "
+                        "-chunk, -symbol-ids, -share-names, -share-types, "
+                        "-share-terms or -outline-blocks\n";
+        return 1;
+    }
+
+    if (!FilterFile.empty() || !IncludePaths.empty() ||
+        !ExcludePaths.empty() || !IncludeNamespaces.empty() ||
+        !ExcludeNamespaces.empty()) {
+        Paths = std::make_unique<PathRules>();
+        if (!FilterFile.empty() && !Paths->read(FilterFile)) {
+            return 1;
+        }
+        // the rules on the command line are applied in the order that they
+        // are given
+        struct Rule {
+            unsigned position;
+            bool include;
+            PathRules::Kind kind;
+            std::string pattern;
+        };
+        std::vector<Rule> rules;
+        auto collect = [&](cl::list<std::string> &opts, bool include,
+                           PathRules::Kind kind) {
+            for (unsigned i = 0; i < opts.size(); ++i) {
+                rules.push_back(
+                    Rule{opts.getPosition(i), include, kind, opts[i]});
+            }
+        };
+        collect(IncludePaths, true, PathRules::Kind::Path);
+        collect(ExcludePaths, false, PathRules::Kind::Path);
+        collect(IncludeNamespaces, true, PathRules::Kind::Namespace);
+        collect(ExcludeNamespaces, false, PathRules::Kind::Namespace);
+        std::sort(rules.begin(), rules.end(),
+                  [](const Rule &a, const Rule &b) {
+                      return a.position < b.position;
+                  });
+        for (auto &r : rules) {
+            if (!Paths->add(r.include, r.kind, r.pattern)) {
+                llvm::errs() << "Invalid path pattern: " << r.pattern << "\n";
+                return 1;
+            }
+        }
+    }
+
+    if (!ServerSocket.empty()) {
+        // note: the cache and the header libraries are keyed by the options
+        // that each request parses with, which the server does not know
+        if (!CacheDir.empty() || !HeaderLibDir.empty()) {
+            llvm::errs() << "-cache-dir and -header-lib-dir can not be "
+                            "combined with -server\n";
+            return 1;
+        }
+        return run_server(ServerSocket, argv[0], ServerUnits, ServerTimeout,
+                          translation_options(""));
+    }
+
+    if (OptionsParser.getSourcePathList().empty()) {
+        llvm::errs() << "No source files given\n";
+        return 1;
+    }
+
+    if (!OutDir.empty()) {
+        if (!VFileOutput.empty() || !NamesFile.empty() || !SpecFile.empty()) {
+            llvm::errs() << "-o, -names and -spec can not be combined with "
+                            "-out-dir, use -out-pattern, -names-pattern and "
+                            "-spec-pattern instead\n";
+            return 1;
+        }
+        if (auto ec = llvm::sys::fs::create_directories(OutDir)) {
+            llvm::errs() << "Failed to create output directory: " << OutDir
+                         << "\n"
+                         << ec.message() << "\n";
+            return 1;
+        }
+        // two sources with the same name would silently overwrite each other
+        std::set<std::string> modules;
+        for (auto &source : OptionsParser.getSourcePathList()) {
+            auto path = out_path(OutPattern, source);
+            if (!modules.insert(path).second) {
+                llvm::errs() << "Multiple sources are translated to " << path
+                             << ", translate them in separate runs\n";
+                return 1;
+            }
+        }
+    }
+
+    if (!CacheDir.empty()) {
+        Cache = std::make_unique<TranslationCache>(CacheDir);
+    }
+
+    if (!HeaderLibDir.empty()) {
+        // note: a library is written by the first translation unit that
+        // includes its header, so it would only hold the declarations that
+        // this unit reaches
+        if (Prune || !Roots.empty()) {
+            llvm::errs() << "-prune and -root can not be combined with "
+                            "-header-lib-dir\n";
+            return 1;
+        }
+        if (auto ec = llvm::sys::fs::create_directories(HeaderLibDir)) {
+            llvm::errs() << "Failed to create header library directory: "
+                         << HeaderLibDir << "\n"
+                         << ec.message() << "\n";
+            return 1;
+        }
+        Libraries = std::make_unique<HeaderLibraries>(HeaderLibDir);
+    }
+
+    // the workers would write the outputs of every translation unit to the
+    // same files at the same time
+    if (Jobs > 1 && OutDir.empty() &&
+        (!VFileOutput.empty() || !NamesFile.empty() || !SpecFile.empty())) {
+        llvm::errs() << "-j can not be combined with -o, -names or -spec, use "
+                        "-out-dir instead\n";
+        return 1;
+    }
+
+#if CLANG_VERSION_MAJOR < 8
+    // note: older versions of clang change the working directory of the whole
+    // process when running a tool, so the workers would race.
+    if (Jobs > 1) {
+        logging::log() << "-j is not supported with clang "
+                       << CLANG_VERSION_MAJOR << ", translating sequentially\n";
+        Jobs = 1;
+    }
+#endif
+
+    if (Jobs > 1 && OptionsParser.getSourcePathList().size() > 1) {
+        return run_parallel(OptionsParser.getCompilations(),
+                            OptionsParser.getSourcePathList(), Jobs);
+    }
+
     ClangTool Tool(OptionsParser.getCompilations(),
                    OptionsParser.getSourcePathList());
 
@@ -159,6 +159,15 @@ Qed.
 Definition build {e} (b : IM.Raw.t e) (pf : Is_true (check_canon None None b)) :IM.t e :=
   {| IM.this := b; IM.is_bst := check_canon_ok _ _ pf |}.
 
+(* a map from a tree that is expected to be sorted, e.g. one printed by
+   cpp2v. checking the order is deferred until the map is used, and a tree
+   that is not sorted is rebuilt by insertion. *)
+Definition of_sorted {e} (b : IM.Raw.t e) : IM.t e :=
+  match check_canon None None b as X return (X -> IM.Raw.bst b) -> _ with
+  | true => fun x => {| IM.this := b; IM.is_bst := x I |}
+  | false => fun _ => list_to_map (IM.Raw.elements b)
+  end (@check_canon_ok _ b).
+
 (* this canonicalizes the proof *)
 Definition map_canon {e} (b : IM.t e) : IM.t e :=
   match check_canon None None b.(IM.this) as X return (X -> IM.Raw.bst b.(IM.this)) -> _ with
@@ -7,7 +7,7 @@ Require Export
         Coq.Lists.List
         Coq.ZArith.BinInt.
 
-Require Import stdpp.gmap.
+Require Import stdpp.gmap stdpp.pmap.
 Require Export bedrock.lang.cpp.ast.
 
 Set Default Proof Using "Type".
@@ -99,6 +99,115 @@ Definition decls ls : translation_unit :=
   decls' ls ∅ ∅ (fun a b => {| symbols := avl.map_canon a
                            ; globals := avl.map_canon b |}).
 
+(** combine translation units that were generated separately (e.g. the parts
+    of a split module), later translation units take precedence as if their
+    declarations came later in [decls]
+ *)
+Definition translation_unit_merge (a b : translation_unit) : translation_unit :=
+  {| symbols := avl.map_canon (IM.fold (fun k v acc => <[ k := v ]> acc) b.(symbols) a.(symbols))
+   ; globals := avl.map_canon (IM.fold (fun k v acc => <[ k := v ]> acc) b.(globals) a.(globals)) |}.
+
+Definition translation_units (ls : list translation_unit) : translation_unit :=
+  List.fold_left translation_unit_merge ls {| symbols := ∅ ; globals := ∅ |}.
+
+(** the trees of a module that cpp2v printed sorted (with -sorted-module), the
+    tables are built with [avl.of_sorted] rather than by reduction
+ *)
+Notation Rleaf := (@IM.Raw.Leaf _) (only parsing).
+Notation Rnode := (@IM.Raw.Node _) (only parsing).
+
+(** a table keyed by the dense ids that cpp2v assigns to names (with
+    -symbol-ids), lookups in it compare numbers rather than names
+ *)
+Definition by_id {V} (ids : list (bs * positive)) (m : IM.t V) : Pmap V :=
+  List.fold_left (fun acc '(n, id) =>
+                    match m !! n with
+                    | Some v => <[ id := v ]> acc
+                    | None => acc
+                    end) ids ∅.
+
+(** string literals with bytes that can not be written in a Coq string are
+    printed by cpp2v with the escapes [\xNN] (lower case hex digits) and
+    [\\], which [bs_unescape] decodes
+ *)
+Definition hex_digit (b : Byte.byte) : N :=
+  let n := Byte.to_N b in
+  if N.ltb n 97 then N.sub n 48 else N.sub n 87.
+
+Definition hex_byte (h l : Byte.byte) : Byte.byte :=
+  match Byte.of_N (N.add (N.mul (hex_digit h) 16) (hex_digit l)) with
+  | Some b => b
+  | None => Byte.x00
+  end.
+
+Fixpoint bs_unescape (s : bs) : bs :=
+  match s with
+  | Bytestring.EmptyString => Bytestring.EmptyString
+  | Bytestring.String b rest =>
+    if Byte.eqb b Byte.x5c then
+      match rest with
+      | Bytestring.String Byte.x5c rest =>
+        Bytestring.String Byte.x5c (bs_unescape rest)
+      | Bytestring.String Byte.x78
+          (Bytestring.String h (Bytestring.String l rest)) =>
+        Bytestring.String (hex_byte h l) (bs_unescape rest)
+      | _ => Bytestring.String b (bs_unescape rest)
+      end
+    else Bytestring.String b (bs_unescape rest)
+  end.
+
+(** large arrays of literals are printed by cpp2v as one string, which is
+    expanded to the same elements. [Einitlist_blob] expands the bytes of an
+    array of characters, and [Einitlist_chars], [Einitlist_ints] and
+    [Einitlist_cast_ints] the decimal values (separated by spaces) of an
+    array of (wide) characters, integers and integers that are converted to
+    the type of the elements
+ *)
+Definition Einitlist_blob (data : bs) (elem : type) (filler : option Expr)
+           (t : type) : Expr :=
+  Einitlist (List.map (fun b => Echar (Z.of_N (Byte.to_N b)) elem)
+                      (Bytestring.print data)) filler t.
+
+Fixpoint parse_ints (s : bs) (neg : bool) (n : option N) : list Z :=
+  let value n := if neg then Z.opp (Z.of_N n) else Z.of_N n in
+  match s with
+  | Bytestring.EmptyString =>
+    match n with
+    | Some n => value n :: nil
+    | None => nil
+    end
+  | Bytestring.String b rest =>
+    if Byte.eqb b Byte.x20 then
+      match n with
+      | Some n => value n :: parse_ints rest false None
+      | None => parse_ints rest false None
+      end
+    else if Byte.eqb b Byte.x2d then parse_ints rest true n
+    else
+      let d := N.sub (Byte.to_N b) 48 in
+      match n with
+      | Some n => parse_ints rest neg (Some (N.add (N.mul n 10) d))
+      | None => parse_ints rest neg (Some d)
+      end
+  end.
+
+Definition Einitlist_chars (data : bs) (elem : type) (filler : option Expr)
+           (t : type) : Expr :=
+  Einitlist (List.map (fun z => Echar z elem) (parse_ints data false None))
+            filler t.
+
+Definition Einitlist_ints (data : bs) (elem : type) (filler : option Expr)
+           (t : type) : Expr :=
+  Einitlist (List.map (fun z => Eint z elem) (parse_ints data false None))
+            filler t.
+
+Definition Einitlist_cast_ints (data : bs) (from elem : type)
+           (filler : option Expr) (t : type) : Expr :=
+  Einitlist (List.map (fun z => Ecast (CCcast Cintegral) (Rvalue, Eint z from)
+                                      elem)
+                      (parse_ints data false None))
+            filler t.
+
 Declare Reduction reduce_translation_unit := vm_compute.
 
 Export Bytestring.